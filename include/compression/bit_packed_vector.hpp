@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace CoGaDB {
+
+    /*!
+     *  \brief This class stores unsigned integer codes with a fixed number of bits per value.
+     *  \details The bit width grows automatically when a value is stored that does not fit into the current width,
+     *  all stored values are repacked in this case. Values may span two consecutive 64 bit words.
+     */
+    class BitPackedVector {
+    public:
+        /***************** constructors and destructor *****************/
+        explicit BitPackedVector(unsigned int bit_width = 1);
+
+        /*! \brief returns the value at position index*/
+        [[nodiscard]] inline uint32_t operator[](size_t index) const;
+
+        /*! \brief overwrites the value at position index, widens the vector if value does not fit*/
+        inline void set(size_t index, uint32_t value);
+
+        /*! \brief appends value, widens the vector if value does not fit*/
+        inline void push_back(uint32_t value);
+
+        [[nodiscard]] uint32_t back() const { return (*this)[size_ - 1]; }
+
+        /*! \brief inserts value in front of position index and shifts all following values, widens the vector if
+         * value does not fit*/
+        void insert(size_t index, uint32_t value);
+
+        /*! \brief removes the value at position index and shifts all following values*/
+        void erase(size_t index);
+
+        /*! \brief decodes the values in [begin, end) to out*/
+        void unpack(size_t begin, size_t end, uint32_t *out) const;
+
+        void reserve(size_t count) { words_.reserve(wordsFor(count, bit_width_)); }
+
+        void clear();
+
+        /*! \brief repacks all values with new_bit_width bits per value, new_bit_width must not be smaller than the
+         * current width*/
+        void widen(unsigned int new_bit_width);
+
+        [[nodiscard]] size_t size() const noexcept { return size_; }
+
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+        [[nodiscard]] unsigned int bitWidth() const noexcept { return bit_width_; }
+
+        /*! \brief returns the size in bytes the packed values consume in main memory*/
+        [[nodiscard]] size_t getSizeInBytes() const noexcept { return words_.capacity() * sizeof(uint64_t); }
+
+        /*! \brief returns the number of bits needed to store max_value (at least one)*/
+        static unsigned int requiredBits(uint32_t max_value);
+
+        template<class Archive>
+        void serialize(Archive &archive) {
+            archive(bit_width_, size_, words_);
+        }
+
+    private:
+        static size_t wordsFor(size_t count, unsigned int bit_width) {
+            // one additional word, so a value may always be read from two consecutive words
+            return (count * bit_width + 63) / 64 + 1;
+        }
+
+        [[nodiscard]] uint64_t mask() const { return (uint64_t(1) << bit_width_) - 1; }
+
+        unsigned int bit_width_;
+        uint64_t size_ = 0;
+        std::vector<uint64_t> words_;
+    };
+
+    /***************** Start of Implementation Section ******************/
+
+    inline BitPackedVector::BitPackedVector(unsigned int bit_width) : bit_width_(bit_width == 0 ? 1 : bit_width),
+                                                                       words_(1, 0) {}
+
+    inline uint32_t BitPackedVector::operator[](size_t index) const {
+        size_t bit = index * bit_width_;
+        size_t word = bit / 64;
+        unsigned int offset = bit % 64;
+        uint64_t value = words_[word] >> offset;
+        if (offset + bit_width_ > 64)
+            value |= words_[word + 1] << (64 - offset);
+        return static_cast<uint32_t>(value & mask());
+    }
+
+    inline void BitPackedVector::set(size_t index, uint32_t value) {
+        if (value > mask())
+            widen(requiredBits(value));
+        size_t bit = index * bit_width_;
+        size_t word = bit / 64;
+        unsigned int offset = bit % 64;
+        words_[word] = (words_[word] & ~(mask() << offset)) | (uint64_t(value) << offset);
+        if (offset + bit_width_ > 64) {
+            unsigned int shift = 64 - offset;
+            words_[word + 1] = (words_[word + 1] & ~(mask() >> shift)) | (uint64_t(value) >> shift);
+        }
+    }
+
+    inline void BitPackedVector::push_back(uint32_t value) {
+        if (value > mask())
+            widen(requiredBits(value));
+        size_++;
+        words_.resize(wordsFor(size_, bit_width_), 0);
+        set(size_ - 1, value);
+    }
+
+    inline void BitPackedVector::insert(size_t index, uint32_t value) {
+        push_back(value);
+        for (size_t i = size_ - 1; i > index; i--)
+            set(i, (*this)[i - 1]);
+        set(index, value);
+    }
+
+    inline void BitPackedVector::erase(size_t index) {
+        for (size_t i = index; i + 1 < size_; i++)
+            set(i, (*this)[i + 1]);
+        size_--;
+        set(size_, 0);
+        words_.resize(wordsFor(size_, bit_width_));
+    }
+
+    inline void BitPackedVector::unpack(size_t begin, size_t end, uint32_t *out) const {
+        const uint64_t value_mask = mask();
+        size_t bit = begin * bit_width_;
+        for (size_t i = begin; i < end; i++, bit += bit_width_) {
+            size_t word = bit / 64;
+            unsigned int offset = bit % 64;
+            uint64_t value = words_[word] >> offset;
+            if (offset + bit_width_ > 64)
+                value |= words_[word + 1] << (64 - offset);
+            *out++ = static_cast<uint32_t>(value & value_mask);
+        }
+    }
+
+    inline void BitPackedVector::clear() {
+        size_ = 0;
+        words_.assign(1, 0);
+    }
+
+    inline void BitPackedVector::widen(unsigned int new_bit_width) {
+        if (new_bit_width <= bit_width_)
+            return;
+        BitPackedVector widened(new_bit_width);
+        // keep the reservation: the values the old words had room for still fit after widening
+        size_t reserved = words_.capacity() > 1 ? (words_.capacity() - 1) * 64 / bit_width_ : 0;
+        widened.words_.reserve(wordsFor(std::max(size_, reserved), new_bit_width));
+        widened.words_.resize(wordsFor(size_, new_bit_width), 0);
+        widened.size_ = size_;
+        for (size_t i = 0; i < size_; i++)
+            widened.set(i, (*this)[i]);
+        *this = std::move(widened);
+    }
+
+    inline unsigned int BitPackedVector::requiredBits(uint32_t max_value) {
+        unsigned int bits = 1;
+        while (bits < 32 && (max_value >> bits) != 0)
+            bits++;
+        return bits;
+    }
+
+    /***************** End of Implementation Section ******************/
+
+} // namespace CoGaDB
@@ -0,0 +1,636 @@
+#pragma once
+
+#include "compressed_column.hpp"
+#include "core/bitmap.hpp"
+#include "core/global_definitions.hpp"
+#include "cereal/types/vector.hpp"
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <stdexcept>
+
+namespace CoGaDB {
+
+    /*!
+     *  \brief This class represents a bit-vector encoded column with type T.
+     *  \details Every distinct value owns a bitmap over all rows, bit i is set if row i holds the value. A value whose
+     *  rows form few runs stores them as sorted run list instead of one bit per row, whichever is smaller. EQUAL
+     *  selections return the bitmap of the value, LESSER and GREATER selections OR the bitmaps of the qualifying
+     *  values, or of the others and invert the result if they cover fewer rows. Accessing a single row has to test
+     *  the bitmaps of all values, so the encoding suits columns with few distinct values that are filtered far more
+     *  often than they are read row by row or updated.
+     */
+    template<class T>
+    class BitVectorEncodedColumn final : public CompressedColumn<T> {
+    public:
+        /***************** constructors and destructor *****************/
+        explicit BitVectorEncodedColumn(const std::string &name);
+
+        ~BitVectorEncodedColumn() final;
+
+        void insert(const ColumnType &new_Value) final;
+
+        void insert(const T &new_value) final;
+
+        /*! \brief appends the values and chooses the smaller form of every bitmap*/
+        template<typename InputIterator>
+        void insert(InputIterator first, InputIterator last);
+
+        void update(TID tid, const ColumnType &new_value) final;
+
+        void update(PositionList &tid, const ColumnType &new_value) final;
+
+        void remove(TID tid) final;
+
+        // assumes tid list is sorted ascending
+        void remove(PositionList &tid) final;
+
+        void clearContent() final;
+
+        ColumnType get(TID tid) final;
+
+        std::string print() const noexcept final;
+
+        [[nodiscard]] size_t size() const noexcept final;
+
+        [[nodiscard]] size_t getSizeInBytes() const noexcept final;
+
+        [[nodiscard]] virtual std::unique_ptr<ColumnBase> copy() const;
+
+        void store(const std::string &path) final;
+
+        void load(const std::string &path) final;
+
+        T operator[](int index) final;
+
+        /*! \brief scatters the value of every bitmap to the rows of [begin, end) it covers*/
+        void decompress(TID begin, TID end, T *out) const final;
+
+        /*! \brief concatenates the rows of the values in value order*/
+        PositionList sort(SortOrder order) final;
+
+        /*! \brief drops values without rows and stores every bitmap in the smaller of both forms*/
+        void reencode();
+
+        /**
+         * @brief Serialization method called by Cereal. Implement this method in your compressed columns to get serialization working.
+         */
+        template<class Archive>
+        void serialize(Archive &archive) {
+            archive(number_of_rows, bitmaps);
+        }
+
+    protected:
+        /*! \brief computes the result bitmap once, the returned scan extracts the set bits of a range*/
+        typename ColumnBaseTyped<T>::RangeSelection prepareSelection(const T &value, ValueComparator comp) final;
+
+        /*! \brief combines the bitmaps of the qualifying values without looking at single rows*/
+        typename ColumnBaseTyped<T>::RangeBitmapSelection prepareBitmapSelection(const T &value, ValueComparator comp) final;
+
+        /*! \brief transforms the values, the bitmaps only change if values collide*/
+        void applyScalar(ColumnAlgebraOperation op, const T &value) final;
+
+    private:
+        /*! rows [begin, end) holding a value*/
+        struct Run {
+            TID begin;
+            TID end;
+
+            template<class Archive>
+            void serialize(Archive &archive) {
+                archive(begin, end);
+            }
+        };
+
+        struct ValueBitmap {
+            /*! value of the rows in this bitmap*/
+            T value{};
+            /*! true if the rows are stored in bits, false if they are stored in runs*/
+            bool dense = false;
+            /*! one bit per row of the column, only used if dense*/
+            Bitmap bits;
+            /*! sorted runs that neither overlap nor touch, only used if not dense*/
+            std::vector<Run> runs;
+            /*! number of rows holding the value*/
+            TID count = 0;
+
+            template<class Archive>
+            void serialize(Archive &archive) {
+                archive(value, dense, bits, runs, count);
+            }
+        };
+
+        /*! \brief returns the bitmap of value, creates an empty one if necessary*/
+        uint32_t acquireSlot(const T &value);
+
+        /*! \brief returns the slot of the value of row tid*/
+        uint32_t slotOf(TID tid) const;
+
+        /*! \brief returns true if the slot contains row tid*/
+        bool contains(uint32_t slot, TID tid) const;
+
+        void setRow(uint32_t slot, TID tid);
+
+        void clearRow(uint32_t slot, TID tid);
+
+        /*! \brief stores the bitmap of slot in bits if its runs need more space*/
+        void chooseForm(uint32_t slot);
+
+        /*! \brief sets the rows of slot in [begin, end) in result*/
+        void addRows(uint32_t slot, Bitmap &result, TID begin, TID end) const;
+
+        /*! \brief returns the slots whose rows are combined for the predicate and true if the combined rows have to be
+         * inverted*/
+        std::pair<std::vector<uint32_t>, bool> qualifyingSlots(const T &value, ValueComparator comp) const;
+
+        /*! \brief sets the rows in [begin, end) satisfying the predicate in result*/
+        void selectRows(const std::vector<uint32_t> &slots, bool inverted, Bitmap &result, TID begin, TID end) const;
+
+        TID number_of_rows;
+        /*! slot of every value, ordered by value*/
+        std::map<T, uint32_t> index;
+        std::vector<ValueBitmap> bitmaps;
+    };
+
+    /***************** Start of Implementation Section ******************/
+
+    template<class T>
+    BitVectorEncodedColumn<T>::BitVectorEncodedColumn(const std::string &name)
+            : CompressedColumn<T>(name), number_of_rows(0), index(), bitmaps() {
+    }
+
+    template<class T>
+    BitVectorEncodedColumn<T>::~BitVectorEncodedColumn() = default;
+
+    template<class T>
+    uint32_t BitVectorEncodedColumn<T>::acquireSlot(const T &value) {
+        auto it = index.find(value);
+        if (it != index.end())
+            return it->second;
+        auto slot = static_cast<uint32_t>(bitmaps.size());
+        bitmaps.emplace_back();
+        bitmaps.back().value = value;
+        index.emplace(value, slot);
+        return slot;
+    }
+
+    template<class T>
+    bool BitVectorEncodedColumn<T>::contains(uint32_t slot, TID tid) const {
+        const ValueBitmap &bitmap = bitmaps[slot];
+        if (bitmap.dense)
+            return bitmap.bits.test(tid);
+        auto run = std::upper_bound(bitmap.runs.begin(), bitmap.runs.end(), tid,
+                                    [](TID t, const Run &r) { return t < r.begin; });
+        return run != bitmap.runs.begin() && tid < std::prev(run)->end;
+    }
+
+    template<class T>
+    uint32_t BitVectorEncodedColumn<T>::slotOf(TID tid) const {
+        for (uint32_t slot = 0; slot < bitmaps.size(); slot++) {
+            if (bitmaps[slot].count != 0 && contains(slot, tid))
+                return slot;
+        }
+        throw std::logic_error("BitVectorEncodedColumn: row " + std::to_string(tid) + " has no value");
+    }
+
+    template<class T>
+    void BitVectorEncodedColumn<T>::setRow(uint32_t slot, TID tid) {
+        ValueBitmap &bitmap = bitmaps[slot];
+        bitmap.count++;
+        if (bitmap.dense) {
+            bitmap.bits.set(tid);
+            return;
+        }
+        std::vector<Run> &runs = bitmap.runs;
+        auto next = std::upper_bound(runs.begin(), runs.end(), tid, [](TID t, const Run &r) { return t < r.begin; });
+        bool joins_previous = next != runs.begin() && std::prev(next)->end == tid;
+        bool joins_next = next != runs.end() && next->begin == tid + 1;
+        if (joins_previous && joins_next) {
+            std::prev(next)->end = next->end;
+            runs.erase(next);
+        } else if (joins_previous) {
+            std::prev(next)->end++;
+        } else if (joins_next) {
+            next->begin--;
+        } else {
+            runs.insert(next, Run{tid, tid + 1});
+            chooseForm(slot);
+        }
+    }
+
+    template<class T>
+    void BitVectorEncodedColumn<T>::clearRow(uint32_t slot, TID tid) {
+        ValueBitmap &bitmap = bitmaps[slot];
+        bitmap.count--;
+        if (bitmap.dense) {
+            bitmap.bits.reset(tid);
+            return;
+        }
+        std::vector<Run> &runs = bitmap.runs;
+        auto run = std::prev(std::upper_bound(runs.begin(), runs.end(), tid,
+                                              [](TID t, const Run &r) { return t < r.begin; }));
+        if (run->begin == tid && run->end == tid + 1) {
+            runs.erase(run);
+        } else if (run->begin == tid) {
+            run->begin++;
+        } else if (run->end == tid + 1) {
+            run->end--;
+        } else {
+            // split the run around tid
+            Run tail{tid + 1, run->end};
+            run->end = tid;
+            runs.insert(std::next(run), tail);
+            chooseForm(slot);
+        }
+    }
+
+    template<class T>
+    void BitVectorEncodedColumn<T>::chooseForm(uint32_t slot) {
+        ValueBitmap &bitmap = bitmaps[slot];
+        size_t bits_size = (size_t(number_of_rows) + 63) / 64 * sizeof(uint64_t);
+        if (bitmap.dense || bitmap.runs.size() * sizeof(Run) <= bits_size)
+            return;
+        bitmap.bits = Bitmap(number_of_rows);
+        for (const Run &run: bitmap.runs)
+            bitmap.bits.setRange(run.begin, run.end);
+        bitmap.runs = std::vector<Run>();
+        bitmap.dense = true;
+    }
+
+    template<class T>
+    void BitVectorEncodedColumn<T>::reencode() {
+        std::map<T, uint32_t> new_index;
+        std::vector<ValueBitmap> new_bitmaps;
+        size_t bits_size = (size_t(number_of_rows) + 63) / 64 * sizeof(uint64_t);
+        for (const auto &entry: index) {
+            ValueBitmap &bitmap = bitmaps[entry.second];
+            if (bitmap.count == 0)
+                continue;
+            if (bitmap.dense) {
+                // a run starts at every set bit whose predecessor is not set
+                size_t number_of_runs = 0;
+                uint64_t carry = 0;
+                for (uint64_t word: bitmap.bits.words()) {
+                    number_of_runs += __builtin_popcountll(word & ~((word << 1) | carry));
+                    carry = word >> 63;
+                }
+                if (number_of_runs * sizeof(Run) <= bits_size) {
+                    for (TID tid = 0; tid < number_of_rows; tid++) {
+                        if (!bitmap.bits.test(tid))
+                            continue;
+                        if (!bitmap.runs.empty() && bitmap.runs.back().end == tid)
+                            bitmap.runs.back().end++;
+                        else
+                            bitmap.runs.push_back(Run{tid, tid + 1});
+                    }
+                    bitmap.bits = Bitmap();
+                    bitmap.dense = false;
+                }
+            }
+            new_index.emplace(entry.first, static_cast<uint32_t>(new_bitmaps.size()));
+            new_bitmaps.push_back(std::move(bitmap));
+        }
+        index = std::move(new_index);
+        bitmaps = std::move(new_bitmaps);
+        for (uint32_t slot = 0; slot < bitmaps.size(); slot++)
+            chooseForm(slot);
+    }
+
+    template<class T>
+    void BitVectorEncodedColumn<T>::insert(const ColumnType &new_Value) {
+        this->insert(std::get<T>(new_Value));
+    }
+
+    template<class T>
+    void BitVectorEncodedColumn<T>::insert(const T &new_value) {
+        uint32_t slot = acquireSlot(new_value);
+        number_of_rows++;
+        for (ValueBitmap &bitmap: bitmaps) {
+            if (bitmap.dense)
+                bitmap.bits.resize(number_of_rows);
+        }
+        setRow(slot, number_of_rows - 1);
+    }
+
+    template<typename T>
+    template<typename InputIterator>
+    void BitVectorEncodedColumn<T>::insert(InputIterator first, InputIterator last) {
+        // grow the bitmaps once for all new rows
+        std::vector<T> values(first, last);
+        TID first_row = number_of_rows;
+        number_of_rows += static_cast<TID>(values.size());
+        for (ValueBitmap &bitmap: bitmaps) {
+            if (bitmap.dense)
+                bitmap.bits.resize(number_of_rows);
+        }
+        for (size_t i = 0; i < values.size(); i++)
+            setRow(acquireSlot(values[i]), first_row + static_cast<TID>(i));
+        reencode();
+    }
+
+    template<class T>
+    void BitVectorEncodedColumn<T>::update(TID tid, const ColumnType &new_value) {
+        if (tid >= number_of_rows)
+            throw std::out_of_range("BitVectorEncodedColumn::update(): invalid tid " + std::to_string(tid));
+
+        uint32_t new_slot = acquireSlot(std::get<T>(new_value));
+        uint32_t old_slot = slotOf(tid);
+        if (old_slot == new_slot)
+            return;
+        clearRow(old_slot, tid);
+        setRow(new_slot, tid);
+    }
+
+    template<class T>
+    void BitVectorEncodedColumn<T>::update(PositionList &tids, const ColumnType &new_value) {
+        for (TID tid: tids)
+            update(tid, new_value);
+    }
+
+    template<class T>
+    void BitVectorEncodedColumn<T>::remove(TID tid) {
+        if (tid >= number_of_rows)
+            throw std::out_of_range("BitVectorEncodedColumn::remove(): invalid tid " + std::to_string(tid));
+
+        clearRow(slotOf(tid), tid);
+        // no other bitmap contains tid, the rows behind it move one position to the front
+        for (ValueBitmap &bitmap: bitmaps) {
+            if (bitmap.dense) {
+                bitmap.bits.erase(tid);
+                continue;
+            }
+            std::vector<Run> &runs = bitmap.runs;
+            auto next = std::upper_bound(runs.begin(), runs.end(), tid, [](TID t, const Run &r) { return t < r.begin; });
+            for (auto run = next; run != runs.end(); ++run) {
+                run->begin--;
+                run->end--;
+            }
+            if (next != runs.begin() && next != runs.end() && std::prev(next)->end == next->begin) {
+                std::prev(next)->end = next->end;
+                runs.erase(next);
+            }
+        }
+        number_of_rows--;
+    }
+
+    template<class T>
+    void BitVectorEncodedColumn<T>::remove(PositionList &tids) {
+        // rebuilding once is cheaper than shifting all bitmaps for every tid
+        std::vector<T> values = this->materializeValues();
+        std::vector<T> remaining;
+        remaining.reserve(values.size());
+        auto next = tids.begin();
+        for (TID tid = 0; tid < values.size(); tid++) {
+            if (next != tids.end() && *next == tid) {
+                ++next;
+                continue;
+            }
+            remaining.push_back(std::move(values[tid]));
+        }
+        clearContent();
+        insert(remaining.begin(), remaining.end());
+    }
+
+    template<class T>
+    void BitVectorEncodedColumn<T>::clearContent() {
+        number_of_rows = 0;
+        index.clear();
+        bitmaps.clear();
+    }
+
+    template<class T>
+    ColumnType BitVectorEncodedColumn<T>::get(TID tid) {
+        if (tid >= number_of_rows)
+            throw std::out_of_range("BitVectorEncodedColumn::get(): invalid tid " + std::to_string(tid));
+        return (*this)[tid];
+    }
+
+    template<class T>
+    T BitVectorEncodedColumn<T>::operator[](const int index_) {
+        return bitmaps[slotOf(static_cast<TID>(index_))].value;
+    }
+
+    template<class T>
+    void BitVectorEncodedColumn<T>::decompress(TID begin, TID end, T *out) const {
+        if (begin >= end)
+            return;
+        for (const auto &entry: index) {
+            const ValueBitmap &bitmap = bitmaps[entry.second];
+            if (bitmap.count == 0)
+                continue;
+            if (bitmap.dense) {
+                const std::vector<uint64_t> &words = bitmap.bits.words();
+                for (size_t w = begin / 64; w * 64 < end; w++) {
+                    uint64_t word = words[w];
+                    if (w * 64 < begin)
+                        word &= ~uint64_t(0) << (begin % 64);
+                    for (; word != 0; word &= word - 1) {
+                        size_t tid = w * 64 + __builtin_ctzll(word);
+                        if (tid >= end)
+                            break;
+                        out[tid - begin] = entry.first;
+                    }
+                }
+                continue;
+            }
+            auto run = std::upper_bound(bitmap.runs.begin(), bitmap.runs.end(), begin,
+                                        [](TID t, const Run &r) { return t < r.begin; });
+            if (run != bitmap.runs.begin())
+                --run;
+            for (; run != bitmap.runs.end() && run->begin < end; ++run) {
+                TID first = std::max(run->begin, begin), last = std::min(run->end, end);
+                if (first < last)
+                    std::fill(out + (first - begin), out + (last - begin), entry.first);
+            }
+        }
+    }
+
+    template<class T>
+    void BitVectorEncodedColumn<T>::addRows(uint32_t slot, Bitmap &result, TID begin, TID end) const {
+        const ValueBitmap &bitmap = bitmaps[slot];
+        if (bitmap.dense) {
+            result.orRange(bitmap.bits, begin, end);
+            return;
+        }
+        auto run = std::lower_bound(bitmap.runs.begin(), bitmap.runs.end(), begin,
+                                    [](const Run &r, TID tid) { return r.end <= tid; });
+        for (; run != bitmap.runs.end() && run->begin < end; ++run)
+            result.setRange(std::max(run->begin, begin), std::min(run->end, end));
+    }
+
+    template<class T>
+    std::pair<std::vector<uint32_t>, bool> BitVectorEncodedColumn<T>::qualifyingSlots(const T &value,
+                                                                                     const ValueComparator comp) const {
+        std::vector<uint32_t> slots;
+        if (comp == EQUAL) {
+            auto it = index.find(value);
+            if (it != index.end())
+                slots.push_back(it->second);
+            return {slots, false};
+        }
+
+        // the qualifying values are a prefix (LESSER) or a suffix (GREATER) of the index
+        auto bound = comp == LESSER ? index.lower_bound(value) : index.upper_bound(value);
+        auto first = comp == LESSER ? index.begin() : bound;
+        auto last = comp == LESSER ? bound : index.end();
+        size_t qualifying_rows = 0;
+        for (auto it = first; it != last; ++it)
+            qualifying_rows += bitmaps[it->second].count;
+
+        if (2 * qualifying_rows <= number_of_rows) {
+            for (auto it = first; it != last; ++it)
+                slots.push_back(it->second);
+            return {slots, false};
+        }
+        // fewer rows do not qualify, combine their bitmaps and invert the result
+        for (auto it = index.begin(); it != index.end(); ++it) {
+            if (it == first)
+                it = last;
+            if (it == index.end())
+                break;
+            slots.push_back(it->second);
+        }
+        return {slots, true};
+    }
+
+    template<class T>
+    void BitVectorEncodedColumn<T>::selectRows(const std::vector<uint32_t> &slots, bool inverted, Bitmap &result,
+                                               TID begin, TID end) const {
+        for (uint32_t slot: slots)
+            addRows(slot, result, begin, end);
+        if (inverted)
+            result.flipRange(begin, end);
+    }
+
+    template<class T>
+    typename ColumnBaseTyped<T>::RangeBitmapSelection BitVectorEncodedColumn<T>::prepareBitmapSelection(const T &value,
+                                                                                                      const ValueComparator comp) {
+        auto [slots, inverted] = qualifyingSlots(value, comp);
+        return [this, slots = std::move(slots), inverted = inverted](TID begin, TID end, Bitmap &result) {
+            selectRows(slots, inverted, result, begin, end);
+        };
+    }
+
+    template<class T>
+    typename ColumnBaseTyped<T>::RangeSelection BitVectorEncodedColumn<T>::prepareSelection(const T &value, const ValueComparator comp) {
+        auto [slots, inverted] = qualifyingSlots(value, comp);
+        auto rows = std::make_shared<Bitmap>(number_of_rows);
+        selectRows(slots, inverted, *rows, 0, number_of_rows);
+        return [rows](TID begin, TID end, PositionList &result_tids) {
+            const std::vector<uint64_t> &words = rows->words();
+            for (size_t w = begin / 64; w * 64 < end; w++) {
+                uint64_t word = words[w];
+                if (w * 64 < begin)
+                    word &= ~uint64_t(0) << (begin % 64);
+                for (; word != 0; word &= word - 1) {
+                    size_t tid = w * 64 + __builtin_ctzll(word);
+                    if (tid >= end)
+                        break;
+                    result_tids.push_back(static_cast<TID>(tid));
+                }
+            }
+        };
+    }
+
+    template<class T>
+    PositionList BitVectorEncodedColumn<T>::sort(const SortOrder order) {
+        PositionList tids;
+        tids.reserve(number_of_rows);
+        for (const auto &entry: index) {
+            const ValueBitmap &bitmap = bitmaps[entry.second];
+            if (bitmap.dense) {
+                PositionList rows = bitmap.bits.toPositionList();
+                tids.insert(tids.end(), rows.begin(), rows.end());
+                continue;
+            }
+            for (const Run &run: bitmap.runs) {
+                for (TID tid = run.begin; tid < run.end; tid++)
+                    tids.push_back(tid);
+            }
+        }
+        if (order == DESCENDING)
+            std::reverse(tids.begin(), tids.end());
+        return tids;
+    }
+
+    template<class T>
+    void BitVectorEncodedColumn<T>::applyScalar(ColumnAlgebraOperation op, const T &value) {
+        std::map<T, uint32_t> new_index;
+        for (const auto &entry: index) {
+            if (!new_index.emplace(applyOperation(op, entry.first, value), entry.second).second) {
+                // two values collide, e.g. after an integer division, rebuild the bitmaps
+                ColumnBaseTyped<T>::applyScalar(op, value);
+                reencode();
+                return;
+            }
+        }
+        index = std::move(new_index);
+        for (const auto &entry: index)
+            bitmaps[entry.second].value = entry.first;
+    }
+
+    template<class T>
+    std::string BitVectorEncodedColumn<T>::print() const noexcept {
+        std::string str = "| " + this->name_ + " |\n________________________\n";
+        std::vector<T> values(number_of_rows);
+        decompress(0, number_of_rows, values.data());
+        for (const T &value: values) {
+            if constexpr(std::is_same_v<std::string, T>)
+                str.append("| " + value + " |\n");
+            else
+                str.append("| " + std::to_string(value) + " |\n");
+        }
+        return str;
+    }
+
+    template<class T>
+    size_t BitVectorEncodedColumn<T>::size() const noexcept {
+        return number_of_rows;
+    }
+
+    template<class T>
+    size_t BitVectorEncodedColumn<T>::getSizeInBytes() const noexcept {
+        size_t bytes = index.size() * detail::index_entry_bytes<T>;
+        for (const auto &entry: index)
+            bytes += detail::heapBytes(entry.first);
+        for (const ValueBitmap &bitmap: bitmaps) {
+            bytes += detail::heapBytes(bitmap.value);
+            bytes += bitmap.dense ? bitmap.bits.words().size() * sizeof(uint64_t) : bitmap.runs.size() * sizeof(Run);
+        }
+        return bytes;
+    }
+
+    template<class T>
+    std::unique_ptr<ColumnBase> BitVectorEncodedColumn<T>::copy() const {
+        return std::make_unique<BitVectorEncodedColumn<T>>(*this);
+    }
+
+    template<class T>
+    void BitVectorEncodedColumn<T>::store(const std::string &path) {
+        std::string path_(path);
+        path_ += this->name_;
+
+        std::ofstream outfile(path_.c_str(), std::ofstream::binary | std::ofstream::out | std::ofstream::trunc);
+        assert(outfile.is_open());
+        cereal::PortableBinaryOutputArchive oarchive(outfile);
+        oarchive(*this);
+    }
+
+    template<class T>
+    void BitVectorEncodedColumn<T>::load(const std::string &path) {
+        std::string path_(path);
+        path_ += this->name_;
+
+        std::ifstream infile(path_.c_str(), std::ifstream::binary | std::ifstream::in);
+        cereal::PortableBinaryInputArchive ia(infile);
+        ia(*this);
+
+        index.clear();
+        for (uint32_t slot = 0; slot < bitmaps.size(); slot++)
+            index.emplace(bitmaps[slot].value, slot);
+    }
+
+    /***************** End of Implementation Section ******************/
+
+}// namespace CoGaDB
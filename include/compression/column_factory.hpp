@@ -0,0 +1,333 @@
+#pragma once
+
+#include "bit_packed_vector.hpp"
+#include "bit_vector_encoded_column.hpp"
+#include "delta_encoded_column.hpp"
+#include "dictionary_compressed_column.hpp"
+#include "frame_of_reference_column.hpp"
+#include "frame_of_reference_kernels.hpp"
+#include "frequency_partitioned_column.hpp"
+#include "front_coded_dictionary.hpp"
+#include "front_coded_dictionary_column.hpp"
+#include "run_length_compressed_column.hpp"
+#include "xor_compressed_column.hpp"
+#include "core/column.hpp"
+#include "core/global_definitions.hpp"
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace CoGaDB {
+
+    /*! \brief encodings createColumn chooses from*/
+    enum class ColumnEncoding {
+        UNCOMPRESSED,
+        DICTIONARY,
+        RUN_LENGTH,
+        DELTA,
+        FREQUENCY_PARTITIONED,
+        BIT_VECTOR,
+        FRAME_OF_REFERENCE,
+        XOR,
+        FRONT_CODED_DICTIONARY
+    };
+
+    /*!
+     *  \brief Statistics of a batch of values, createColumn estimates the size of every encoding from them.
+     *  \details Besides the general statistics, the encodings whose size depends on more than the number of distinct
+     *  values and runs get their own figure, which is computed in the same pass.
+     */
+    struct ColumnStatistics {
+        size_t number_of_rows = 0;
+        size_t number_of_distinct_values = 0;
+        /*! number of maximal sequences of equal values*/
+        size_t number_of_runs = 0;
+        /*! true if the values are sorted ascending*/
+        bool sorted = true;
+        /*! bytes of string contents stored outside of the std::string objects, for all rows, for the distinct values
+         * and for the first row of every run*/
+        size_t heap_bytes = 0;
+        size_t distinct_heap_bytes = 0;
+        size_t run_heap_bytes = 0;
+        /*! number of rows in each partition of a FrequencyPartitionedColumn*/
+        std::array<size_t, FrequencyPartitionedColumn<int>::NUMBER_OF_PARTITIONS> partition_rows{};
+        /*! bytes of the bitmaps of a BitVectorEncodedColumn, every bitmap takes the smaller of its dense and run form*/
+        size_t bitmap_bytes = 0;
+        /*! bits of the packed offsets of a FrameOfReferenceColumn if every block covers its full value range*/
+        size_t packed_bits = 0;
+        /*! bytes of the full blocks of a XorCompressedColumn*/
+        size_t xor_bytes = 0;
+        /*! bytes of the front coded dictionary of a FrontCodedDictionaryColumn*/
+        size_t front_coded_bytes = 0;
+    };
+
+    /*! \brief a BitVectorEncodedColumn is only considered up to this many distinct values, because range predicates
+     * combine one bitmap per qualifying value*/
+    constexpr size_t BIT_VECTOR_MAX_DISTINCT_VALUES = 64;
+
+    namespace detail {
+        template<class T>
+        constexpr bool is_numeric_column_type = std::is_same_v<T, int> || std::is_same_v<T, float>;
+
+        template<class C, class T>
+        std::unique_ptr<ColumnBaseTyped<T>> makeColumn(const std::string &name, const std::vector<T> &values) {
+            auto column = std::make_unique<C>(name);
+            column->insert(values.begin(), values.end());
+            return column;
+        }
+    } // namespace detail
+
+    /*! \brief computes the statistics of values in a single pass over the values and one over the distinct values*/
+    template<class T>
+    ColumnStatistics computeStatistics(const std::vector<T> &values) {
+        ColumnStatistics statistics;
+        statistics.number_of_rows = values.size();
+
+        struct ValueCounts {
+            size_t rows = 0;
+            size_t runs = 0;
+        };
+        std::unordered_map<T, ValueCounts> counts;
+        for (size_t i = 0; i < values.size(); i++) {
+            ValueCounts &value_counts = counts[values[i]];
+            value_counts.rows++;
+            statistics.heap_bytes += detail::heapBytes(values[i]);
+            if (i == 0 || !(values[i] == values[i - 1])) {
+                value_counts.runs++;
+                statistics.number_of_runs++;
+                statistics.run_heap_bytes += detail::heapBytes(values[i]);
+            }
+            if (i > 0 && values[i] < values[i - 1])
+                statistics.sorted = false;
+        }
+        statistics.number_of_distinct_values = counts.size();
+
+        // a dense bitmap has one bit per row, a run takes a begin and an end
+        const size_t dense_bytes = (values.size() + 63) / 64 * sizeof(uint64_t);
+        std::vector<size_t> frequencies;
+        frequencies.reserve(counts.size());
+        for (const auto &[value, value_counts]: counts) {
+            statistics.distinct_heap_bytes += detail::heapBytes(value);
+            statistics.bitmap_bytes += std::min(dense_bytes, value_counts.runs * 2 * sizeof(TID));
+            frequencies.push_back(value_counts.rows);
+        }
+
+        // the most frequent values fill the narrowest partitions, the widest one takes the rest
+        std::sort(frequencies.begin(), frequencies.end(), std::greater<>());
+        size_t next = 0;
+        for (size_t p = 0; p < statistics.partition_rows.size(); p++) {
+            size_t capacity = p + 1 == statistics.partition_rows.size()
+                              ? frequencies.size()
+                              : size_t(1) << FrequencyPartitionedColumn<T>::PARTITION_BITS[p];
+            for (size_t end = std::min(frequencies.size(), next + capacity); next < end; next++)
+                statistics.partition_rows[p] += frequencies[next];
+        }
+
+        if constexpr(detail::is_numeric_column_type<T>) {
+            for (size_t begin = 0; begin + FOR_BLOCK_SIZE <= values.size(); begin += FOR_BLOCK_SIZE) {
+                auto [min, max] = std::minmax_element(values.begin() + begin, values.begin() + begin + FOR_BLOCK_SIZE,
+                                                      [](T a, T b) { return orderedKey(a) < orderedKey(b); });
+                // a constant block needs no offsets at all
+                uint32_t range = orderedKey(*max) - orderedKey(*min);
+                statistics.packed_bits += range == 0 ? 0 : FOR_BLOCK_SIZE * BitPackedVector::requiredBits(range);
+            }
+
+            constexpr size_t XOR_BLOCK_SIZE = XorCompressedColumn<T>::BLOCK_SIZE;
+            for (size_t begin = 0; begin + XOR_BLOCK_SIZE <= values.size(); begin += XOR_BLOCK_SIZE)
+                statistics.xor_bytes += XorCompressedColumn<T>::encodedSizeInBytes(&values[begin]);
+        } else if constexpr(std::is_same_v<T, std::string>) {
+            std::vector<std::string> dictionary;
+            dictionary.reserve(counts.size());
+            for (const auto &entry: counts)
+                dictionary.push_back(entry.first);
+            std::sort(dictionary.begin(), dictionary.end());
+            statistics.front_coded_bytes = FrontCodedDictionary(dictionary).getSizeInBytes();
+        }
+        return statistics;
+    }
+
+    /*! \brief returns true if createColumn can create a column of type T with encoding*/
+    template<class T>
+    constexpr bool isSupported(ColumnEncoding encoding) {
+        switch (encoding) {
+            case ColumnEncoding::UNCOMPRESSED:
+            case ColumnEncoding::DICTIONARY:
+            case ColumnEncoding::RUN_LENGTH:
+            case ColumnEncoding::FREQUENCY_PARTITIONED:
+            case ColumnEncoding::BIT_VECTOR:
+                return true;
+            case ColumnEncoding::DELTA:
+            case ColumnEncoding::FRAME_OF_REFERENCE:
+            case ColumnEncoding::XOR:
+                return detail::is_numeric_column_type<T>;
+            case ColumnEncoding::FRONT_CODED_DICTIONARY:
+                return std::is_same_v<T, std::string>;
+        }
+        return false;
+    }
+
+    /*! \brief estimates the bytes a column of type T with encoding needs for a batch with the given statistics
+     *  \details the estimates follow the memory layout of the columns, including their indexes and the contents of
+     *  long strings, so they are comparable across encodings*/
+    template<class T>
+    size_t estimateSizeInBytes(ColumnEncoding encoding, const ColumnStatistics &statistics) {
+        if (!isSupported<T>(encoding))
+            return std::numeric_limits<size_t>::max();
+
+        const size_t rows = statistics.number_of_rows;
+        const size_t distinct_values = statistics.number_of_distinct_values;
+        const size_t code_bytes = (rows * BitPackedVector::requiredBits(distinct_values == 0 ? 0 : distinct_values - 1) + 7) / 8;
+        switch (encoding) {
+            case ColumnEncoding::UNCOMPRESSED:
+                return rows * sizeof(T) + statistics.heap_bytes;
+            case ColumnEncoding::DICTIONARY:
+                // dictionary, hash index and reference counts, the index holds a second copy of every value
+                return code_bytes + distinct_values * (sizeof(T) + detail::index_entry_bytes<T> + sizeof(unsigned int)) +
+                       2 * statistics.distinct_heap_bytes;
+            case ColumnEncoding::RUN_LENGTH:
+                return statistics.number_of_runs * (sizeof(std::tuple<unsigned int, T>) + sizeof(TID)) +
+                       statistics.run_heap_bytes;
+            case ColumnEncoding::FREQUENCY_PARTITIONED: {
+                using FPColumn = FrequencyPartitionedColumn<T>;
+                size_t bytes = (rows * BitPackedVector::requiredBits(FPColumn::NUMBER_OF_PARTITIONS - 1) + 7) / 8 +
+                               rows / FPColumn::CHECKPOINT_INTERVAL * FPColumn::NUMBER_OF_PARTITIONS * sizeof(TID) +
+                               distinct_values * (sizeof(T) + detail::index_entry_bytes<T> + sizeof(unsigned int)) +
+                               2 * statistics.distinct_heap_bytes;
+                // the codes of a partition are as wide as its dictionary needs, at most PARTITION_BITS
+                size_t remaining = distinct_values;
+                for (size_t p = 0; p < FPColumn::NUMBER_OF_PARTITIONS; p++) {
+                    size_t partition_values = p + 1 == FPColumn::NUMBER_OF_PARTITIONS
+                                              ? remaining
+                                              : std::min(remaining, size_t(1) << FPColumn::PARTITION_BITS[p]);
+                    remaining -= partition_values;
+                    unsigned int bits = BitPackedVector::requiredBits(partition_values == 0 ? 0 : partition_values - 1);
+                    bytes += (statistics.partition_rows[p] * bits + 7) / 8;
+                }
+                return bytes;
+            }
+            case ColumnEncoding::BIT_VECTOR:
+                // the index and the bitmap both hold a copy of every value
+                return statistics.bitmap_bytes + distinct_values * detail::index_entry_bytes<T> +
+                       2 * statistics.distinct_heap_bytes;
+            case ColumnEncoding::FRONT_CODED_DICTIONARY:
+                return statistics.front_coded_bytes + code_bytes + distinct_values * sizeof(unsigned int);
+            default:
+                break;
+        }
+
+        if constexpr(detail::is_numeric_column_type<T>) {
+            switch (encoding) {
+                case ColumnEncoding::DELTA:
+                    return (rows + rows / DeltaEncodedColumn<T>::BLOCK_SIZE + 1) * sizeof(T);
+                case ColumnEncoding::FRAME_OF_REFERENCE:
+                    // a block stores its reference, range and offsets in about six words, the tail is unpacked
+                    return statistics.packed_bits / 8 + rows / FOR_BLOCK_SIZE * 6 * sizeof(uint32_t) +
+                           rows % FOR_BLOCK_SIZE * sizeof(uint32_t);
+                case ColumnEncoding::XOR:
+                    return statistics.xor_bytes + rows % XorCompressedColumn<T>::BLOCK_SIZE * sizeof(uint32_t);
+                default:
+                    break;
+            }
+        }
+        return std::numeric_limits<size_t>::max();
+    }
+
+    /*! \brief returns the cost of a scan over a column with encoding relative to its size
+     *  \details Most encodings evaluate predicates on codes, runs or packed offsets at about the speed of reading
+     *  them. Frequency partitioning locates the partition of every row, delta encoding has to compute a prefix sum
+     *  and XOR compression decodes bit by bit before comparing.*/
+    inline double scanCostFactor(ColumnEncoding encoding) {
+        switch (encoding) {
+            case ColumnEncoding::FREQUENCY_PARTITIONED:
+                return 1.2;
+            case ColumnEncoding::DELTA:
+                return 1.5;
+            case ColumnEncoding::XOR:
+                return 2.0;
+            default:
+                return 1.0;
+        }
+    }
+
+    /*! \brief returns the encoding with the lowest estimated size weighted by its scan cost
+     *  \details Delta encoding is only considered for sorted values and bit vectors only for few distinct values.
+     *  Ties are resolved in favour of the encoding listed first in ColumnEncoding.*/
+    template<class T>
+    ColumnEncoding chooseEncoding(const ColumnStatistics &statistics) {
+        ColumnEncoding best = ColumnEncoding::UNCOMPRESSED;
+        double best_cost = static_cast<double>(estimateSizeInBytes<T>(best, statistics)) * scanCostFactor(best);
+        for (ColumnEncoding encoding: {ColumnEncoding::DICTIONARY, ColumnEncoding::RUN_LENGTH, ColumnEncoding::DELTA,
+                                       ColumnEncoding::FREQUENCY_PARTITIONED, ColumnEncoding::BIT_VECTOR,
+                                       ColumnEncoding::FRAME_OF_REFERENCE, ColumnEncoding::XOR,
+                                       ColumnEncoding::FRONT_CODED_DICTIONARY}) {
+            if (!isSupported<T>(encoding) ||
+                (encoding == ColumnEncoding::DELTA && !statistics.sorted) ||
+                (encoding == ColumnEncoding::BIT_VECTOR &&
+                 statistics.number_of_distinct_values > BIT_VECTOR_MAX_DISTINCT_VALUES))
+                continue;
+            double cost = static_cast<double>(estimateSizeInBytes<T>(encoding, statistics)) * scanCostFactor(encoding);
+            if (cost < best_cost) {
+                best = encoding;
+                best_cost = cost;
+            }
+        }
+        return best;
+    }
+
+    /*! \brief creates a column of type T with encoding and inserts values
+     *  \details throws std::invalid_argument if the encoding is not supported for T*/
+    template<class T>
+    std::unique_ptr<ColumnBaseTyped<T>> createColumn(ColumnEncoding encoding, const std::string &name,
+                                                     const std::vector<T> &values) {
+        if (!isSupported<T>(encoding))
+            throw std::invalid_argument("createColumn(): encoding " + std::to_string(static_cast<int>(encoding)) +
+                                        " is not supported for column " + name);
+
+        switch (encoding) {
+            case ColumnEncoding::UNCOMPRESSED:
+                return detail::makeColumn<Column<T>>(name, values);
+            case ColumnEncoding::DICTIONARY:
+                return detail::makeColumn<DictionaryCompressedColumn<T>>(name, values);
+            case ColumnEncoding::RUN_LENGTH:
+                return detail::makeColumn<RunLengthCompressedColumn<T>>(name, values);
+            case ColumnEncoding::FREQUENCY_PARTITIONED:
+                return detail::makeColumn<FrequencyPartitionedColumn<T>>(name, values);
+            case ColumnEncoding::BIT_VECTOR:
+                return detail::makeColumn<BitVectorEncodedColumn<T>>(name, values);
+            default:
+                break;
+        }
+        if constexpr(detail::is_numeric_column_type<T>) {
+            switch (encoding) {
+                case ColumnEncoding::DELTA:
+                    return detail::makeColumn<DeltaEncodedColumn<T>>(name, values);
+                case ColumnEncoding::FRAME_OF_REFERENCE:
+                    return detail::makeColumn<FrameOfReferenceColumn<T>>(name, values);
+                case ColumnEncoding::XOR:
+                    return detail::makeColumn<XorCompressedColumn<T>>(name, values);
+                default:
+                    break;
+            }
+        } else if constexpr(std::is_same_v<T, std::string>) {
+            return detail::makeColumn<FrontCodedDictionaryColumn>(name, values);
+        }
+        return nullptr;
+    }
+
+    /*! \brief creates a column of type T with the encoding chosen from the statistics of first_batch and inserts
+     * first_batch
+     *  \details later inserts do not revisit the choice, so first_batch should be representative for the column*/
+    template<class T>
+    std::unique_ptr<ColumnBaseTyped<T>> createColumn(const std::string &name, const std::vector<T> &first_batch) {
+        return createColumn(chooseEncoding<T>(computeStatistics(first_batch)), name, first_batch);
+    }
+
+}// namespace CoGaDB
@@ -1,18 +1,54 @@
 #pragma once
 
 #include "compressed_column.hpp"
+#include "delta_kernels.hpp"
 #include "../core/global_definitions.hpp"
-#include <list>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
 
 namespace CoGaDB {
 
+    namespace detail {
+        /*! \brief integral representation the deltas of a DeltaEncodedColumn are computed in
+         *  \details Deltas are computed with unsigned (wrap-around) arithmetic, floating point values are encoded via
+         *  their bit pattern. This way, decoding reconstructs every value exactly.*/
+        template<class T, class = void>
+        struct DeltaRepresentation {
+            using type = T;
+        };
+
+        template<class T>
+        struct DeltaRepresentation<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+            using type = std::make_unsigned_t<T>;
+        };
+
+        template<>
+        struct DeltaRepresentation<float> {
+            using type = std::uint32_t;
+        };
+
+        template<>
+        struct DeltaRepresentation<double> {
+            using type = std::uint64_t;
+        };
+    } // namespace detail
+
     /*!
      *  \brief This class represents a delta encoded column with type T.
+     *  \details The column is divided into blocks of BLOCK_SIZE values. Besides the deltas, the absolute value of the
+     *  first element of every block (anchor) and the value of the last element are kept, so a point access decodes at
+     *  most one block and an append does not need to decode anything.
      */
     template<class T>
     class DeltaEncodedColumn final : public CompressedColumn<T> {
 
         public:
+            /*! \brief number of values between two anchors*/
+            static constexpr TID BLOCK_SIZE = 128;
+
             /***************** constructors and destructor *****************/
             explicit DeltaEncodedColumn(const std::string &name);
 
@@ -53,6 +89,9 @@ namespace CoGaDB {
 
             T operator[](int index) final;
 
+            /*! \brief the values are reconstructed with a vectorized prefix sum over the deltas*/
+            void decompress(TID begin, TID end, T *out) const final;
+
             /**
              * @brief Serialization method called by Cereal. Implement this method in your compressed columns to get serialization working.
              */
@@ -61,9 +100,29 @@ namespace CoGaDB {
                 archive(values);// serialize things by passing them to the archive
             }
 
+        protected:
+            /*! \brief adding to or scaling integers changes the deltas uniformly, all other operations re-encode*/
+            void applyScalar(ColumnAlgebraOperation op, const T &value) final;
+
         private:
-            std::vector<T> values;
+            using delta_type = typename detail::DeltaRepresentation<T>::type;
+
+            static delta_type encode(const T &value);
 
+            static T decode(const delta_type &value);
+
+            /*! \brief reconstructs the encoded value at position tid starting from the anchor of its block*/
+            delta_type decodeAt(TID tid) const;
+
+            /*! \brief recomputes all anchors of blocks starting at or after position from and the cached last value*/
+            void rebuildAnchors(TID from);
+
+            /*! deltas, the first element holds the (encoded) absolute value of the first row*/
+            std::vector<delta_type> values;
+            /*! encoded absolute value of the first row of every block*/
+            std::vector<delta_type> anchors;
+            /*! encoded absolute value of the last row*/
+            delta_type last_value{};
     };
 
     /***************** Start of Implementation Section ******************/
@@ -78,103 +137,119 @@ namespace CoGaDB {
     template<class T>
     DeltaEncodedColumn<T>::~DeltaEncodedColumn() = default;
 
+    template<class T>
+    typename DeltaEncodedColumn<T>::delta_type DeltaEncodedColumn<T>::encode(const T &value) {
+        if constexpr(std::is_floating_point_v<T>) {
+            delta_type bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        } else {
+            return static_cast<delta_type>(value);
+        }
+    }
+
+    template<class T>
+    T DeltaEncodedColumn<T>::decode(const delta_type &value) {
+        if constexpr(std::is_floating_point_v<T>) {
+            T result;
+            std::memcpy(&result, &value, sizeof(result));
+            return result;
+        } else {
+            return static_cast<T>(value);
+        }
+    }
+
+    template<class T>
+    typename DeltaEncodedColumn<T>::delta_type DeltaEncodedColumn<T>::decodeAt(TID tid) const {
+        TID block_begin = tid - tid % BLOCK_SIZE;
+        delta_type val = anchors[tid / BLOCK_SIZE];
+        for(TID i = block_begin + 1; i <= tid; ++i){
+            val += values[i];
+        }
+        return val;
+    }
+
+    template<class T>
+    void DeltaEncodedColumn<T>::rebuildAnchors(TID from) {
+        if(values.empty()){
+            anchors.clear();
+            last_value = delta_type{};
+            return;
+        }
+        // start at the last anchor in front of position from, which is still valid
+        TID block = from == 0 ? 0 : (from - 1) / BLOCK_SIZE;
+        TID pos = block * BLOCK_SIZE;
+        delta_type val = from == 0 ? values.front() : anchors[block];
+        anchors.resize((values.size() + BLOCK_SIZE - 1) / BLOCK_SIZE);
+        anchors[block] = val;
+        for(TID i = pos + 1; i < values.size(); ++i){
+            val += values[i];
+            if(i % BLOCK_SIZE == 0){
+                anchors[i / BLOCK_SIZE] = val;
+            }
+        }
+        last_value = val;
+    }
+
     template<class T>
     void DeltaEncodedColumn<T>::insert(const ColumnType& col_type) {
-        std::cout << "Insert (coltype): " << std::to_string(std::get<T>(col_type)) << std::endl;
         T value = std::get<T>(col_type);
         DeltaEncodedColumn<T>::insert(value);
     }
 
     template<class T>
     void DeltaEncodedColumn<T>::insert(const T& new_value) {
-        // std::cout << "Insert: " << new_value << std::endl;
-
+        delta_type encoded = encode(new_value);
         if(values.empty()){
-            values.emplace_back(new_value);
-            // std::cout << "  inserting: " << new_value << std::endl;
+            values.emplace_back(encoded);
         }else{
-            T val = values.front();
-            for(size_t i = 1; i < values.size(); ++i){
-                val += values[i];
-            }
-            T val_insert = new_value-val;
-            values.emplace_back(val_insert);
-            // std::cout << "  inserting: " << val_insert << std::endl;
-            // for(size_t i = 0; i < values.size(); ++i){
-            //     std::cout << values[i] << ",";
-            // }
+            values.emplace_back(encoded - last_value);
         }
-
-
-
-        // if (values.empty()){
-        //     values.emplace_front(new_value);
-        // }else{
-        //     auto itr = values.begin();
-        //     T curr_val = values.front();
-
-        //     while(curr_val < new_value && !(itr == values.end())){ 
-        //         curr_val += *itr;
-        //         ++itr;
-        //     }
-
-        //     if(itr == values.begin()){
-        //         T diff = *itr-new_value;
-        //         *itr=diff; // Replace current reference value with diff
-        //         values.emplace_front(new_value);
-        //     }
-        //     else if(itr == values.end()){
-        //         auto last_element = ++values.end();
-        //         T diff = new_value - *last_element;
-        //         values.emplace_back(diff);
-        //     }
-        //     else{
-        //         T diff_back = curr_val - new_value;
-        //         *itr = diff_back;
-        //         auto prev = std::prev(itr, 1);
-        //         T diff_front = new_value - (curr_val - *prev);
-        //         values.insert(itr, diff_front);
-        //     }
-        // }
+        if((values.size() - 1) % BLOCK_SIZE == 0){
+            anchors.emplace_back(encoded);
+        }
+        last_value = encoded;
     }
 
     template<typename T>
     template<typename InputIterator>
     void DeltaEncodedColumn<T>::insert(InputIterator first, InputIterator last) {
+        if constexpr(std::is_base_of_v<std::forward_iterator_tag,
+                                       typename std::iterator_traits<InputIterator>::iterator_category>) {
+            auto count = static_cast<size_t>(std::distance(first, last));
+            values.reserve(values.size() + count);
+            anchors.reserve((values.size() + count + BLOCK_SIZE - 1) / BLOCK_SIZE);
+        }
+        // compute all deltas against one running value
+        delta_type previous = last_value;
         for (InputIterator iit = first; iit != last; ++iit){
-            insert(iit);                                    
+            delta_type encoded = encode(*iit);
+            if(values.size() % BLOCK_SIZE == 0){
+                anchors.emplace_back(encoded);
+            }
+            values.emplace_back(values.empty() ? encoded : encoded - previous);
+            previous = encoded;
         }
+        last_value = previous;
     }
 
     template<class T>
     ColumnType DeltaEncodedColumn<T>::get(TID tid) {
-        auto itr = values.begin();
-        T val = values.front();
-        for(unsigned int i = 0; i < tid; ++i){
-            val += *(++itr);
+        if(tid >= values.size()){
+            throw std::out_of_range("DeltaEncodedColumn::get(): invalid tid " + std::to_string(tid));
         }
-        return val;
+        return decode(decodeAt(tid));
     }
 
     template<class T>
     std::string DeltaEncodedColumn<T>::print() const noexcept {
-        T val = values.front();
-        std::string str = !values.empty() ? std::to_string(val) + "\n"  : "";
-        for(size_t i = 1; i < values.size(); ++i){
-            val += values[i];
-            str.append(std::to_string(val) + ": " + std::to_string(values[i]) + "\n");
-
+        std::string str = "| " + this->name_ + " |\n________________________\n";
+        delta_type val{};
+        for(size_t i = 0; i < values.size(); ++i){
+            val = i == 0 ? values.front() : val + values[i];
+            str.append("| " + std::to_string(decode(val)) + " |\n");
         }
-
         return str;
-
-        // return std::accumulate(values.cbegin(), values.cend(), "| " + this->name_ + " |\n________________________\n",
-        //                        [](std::string acc, const T &cur) {
-        //                            if constexpr(std::is_same_v<std::string, T>)
-        //                                return std::move(acc) + "| " + cur + " |\n";
-        //                            else
-        //                                return std::move(acc) + "| " + std::to_string(cur) + " |\n";
-        //                        });
     }
 
     template<class T>
@@ -189,20 +264,25 @@ namespace CoGaDB {
 
     template<class T>
     void DeltaEncodedColumn<T>::update(TID tid, const ColumnType& value) {
-        std::cout << "Update element at " << tid << " to " << std::get<T>(value) << std::endl;
-        T new_value = std::get<T>(value);
+        if(tid >= values.size()){
+            throw std::out_of_range("DeltaEncodedColumn::update(): invalid tid " + std::to_string(tid));
+        }
+        delta_type new_value = encode(std::get<T>(value));
+        delta_type old_value = decodeAt(tid);
+        // only the delta of the updated row and of its successor change
         if(tid == 0){
-            if (values.size() > 1){
-                values[1] -= new_value;
-            }
             values[0] = new_value;
         }else{
-            if(tid < (values.size() - 1)){
-                T val_after = std::get<T>(get(tid+1));
-                T val_after_new = val_after - new_value;
-                values[tid+1] = val_after_new;
-            }
-            values[tid] = new_value - std::get<T>(get(tid-1));
+            values[tid] += new_value - old_value;
+        }
+        if(tid + 1 < values.size()){
+            values[tid + 1] -= new_value - old_value;
+        }
+        if(tid % BLOCK_SIZE == 0){
+            anchors[tid / BLOCK_SIZE] = new_value;
+        }
+        if(tid + 1 == values.size()){
+            last_value = new_value;
         }
     }
 
@@ -210,42 +290,34 @@ namespace CoGaDB {
     void DeltaEncodedColumn<T>::update(PositionList& tids, const ColumnType& value) {
         for(TID tid: tids){
             update(tid, value);
-        }   
+        }
     }
 
     template<class T>
     void DeltaEncodedColumn<T>::remove(TID tid) {
-        std::cout << "Remove element at " << tid << std::endl;
-        if(values.size() == 1) {
-            values.clear();
-            return;
+        if(tid >= values.size()){
+            throw std::out_of_range("DeltaEncodedColumn::remove(): invalid tid " + std::to_string(tid));
         }
-        if (tid == 0){
-            values[1] += values.front();
-            values.erase(values.begin());
-        }
-        else{
-            if(tid < (values.size() - 1)){
-                T val_before = std::get<T>(get(tid-1));
-                T val_after = std::get<T>(get(tid+1));
-                T new_val = val_after - val_before;
-                values[tid+1] = new_val;
-            }
-            values.erase(values.begin() + tid);
+        // the successor's delta absorbs the delta of the removed row (for tid 0 it becomes the absolute value)
+        if(tid + 1 < values.size()){
+            values[tid + 1] += values[tid];
         }
+        values.erase(values.begin() + tid);
+        rebuildAnchors(tid);
     }
 
     template<class T>
     void DeltaEncodedColumn<T>::remove(PositionList& tids) {
-        for(TID tid : tids){
-            remove(tid);
+        for(auto rit = tids.rbegin(); rit != tids.rend(); ++rit){
+            remove(*rit);
         }
     }
 
     template<class T>
     void DeltaEncodedColumn<T>::clearContent() {
         values.clear();
-        std::cout << "After clearing content size of values is " << values.size() << std::endl;
+        anchors.clear();
+        last_value = delta_type{};
     }
 
     template<class T>
@@ -256,7 +328,7 @@ namespace CoGaDB {
         std::ofstream outfile(path_.c_str(), std::ofstream::binary | std::ofstream::out | std::ofstream::trunc);
         assert(outfile.is_open());
         cereal::PortableBinaryOutputArchive oarchive(outfile); // Create an output archive
-        oarchive(values); 
+        oarchive(values);
     }
 
     template<class T>
@@ -267,17 +339,84 @@ namespace CoGaDB {
         std::ifstream infile(path_.c_str(), std::ifstream::binary | std::ifstream::in);
         cereal::PortableBinaryInputArchive ia(infile);
         ia(values);
+        rebuildAnchors(0);
     }
 
 
     template<class T>
     T DeltaEncodedColumn<T>::operator[](const int indx) {
-        return std::get<T>(get(indx));
+        return decode(decodeAt(indx));
+    }
+
+    template<class T>
+    void DeltaEncodedColumn<T>::decompress(TID begin, TID end, T *out) const {
+        if(begin >= end){
+            return;
+        }
+        delta_type buffer[BLOCK_SIZE];
+        delta_type val = decodeAt(begin);
+        buffer[0] = val;
+        TID pos = begin + 1;
+        TID count = std::min<TID>(BLOCK_SIZE - 1, end - pos);
+        prefixSum(values.data() + pos, count, val, buffer + 1);
+        std::memcpy(out, buffer, (count + 1) * sizeof(T));
+        out += count + 1;
+        pos += count;
+        val = buffer[count];
+        while(pos < end){
+            count = std::min<TID>(BLOCK_SIZE, end - pos);
+            prefixSum(values.data() + pos, count, val, buffer);
+            std::memcpy(out, buffer, count * sizeof(T));
+            out += count;
+            pos += count;
+            val = buffer[count - 1];
+        }
+    }
+
+    template<class T>
+    void DeltaEncodedColumn<T>::applyScalar(ColumnAlgebraOperation op, const T &value) {
+        if(values.empty()){
+            return;
+        }
+        if constexpr(std::is_integral_v<T>) {
+            delta_type operand = encode(value);
+            if(op == ADD || op == SUB){
+                // shifting all values keeps the deltas, only the absolute values move
+                if(op == SUB){
+                    operand = delta_type{} - operand;
+                }
+                values.front() += operand;
+                for(auto &anchor: anchors){
+                    anchor += operand;
+                }
+                last_value += operand;
+                return;
+            }
+            if(op == MUL){
+                // scaling all values scales every delta by the same factor
+                for(auto &delta: values){
+                    delta *= operand;
+                }
+                for(auto &anchor: anchors){
+                    anchor *= operand;
+                }
+                last_value *= operand;
+                return;
+            }
+        }
+        // division and floating point arithmetic do not distribute over the deltas
+        std::vector<T> decoded(values.size());
+        decompress(0, values.size(), decoded.data());
+        for(auto &val: decoded){
+            val = applyOperation(op, val, value);
+        }
+        clearContent();
+        insert(decoded.begin(), decoded.end());
     }
 
     template<class T>
     size_t DeltaEncodedColumn<T>::getSizeInBytes() const noexcept {
-        return sizeof(T) * values.size();
+        return sizeof(delta_type) * (values.size() + anchors.size() + 1);
     }
 
     /***************** End of Implementation Section ******************/
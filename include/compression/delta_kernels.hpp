@@ -0,0 +1,77 @@
+#pragma once
+
+#include <core/cpu_features.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace CoGaDB {
+
+    namespace detail {
+        template<class U>
+        inline void prefixSumScalar(const U *deltas, size_t count, U base, U *out) {
+            for (size_t i = 0; i < count; i++) {
+                base += deltas[i];
+                out[i] = base;
+            }
+        }
+
+#ifdef COGADB_X86_SIMD
+        inline void prefixSumSSE2(const uint32_t *deltas, size_t count, uint32_t base, uint32_t *out) {
+            __m128i carry = _mm_set1_epi32(static_cast<int>(base));
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(deltas + i));
+                x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+                x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+                x = _mm_add_epi32(x, carry);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), x);
+                carry = _mm_shuffle_epi32(x, 0xFF);
+            }
+            prefixSumScalar(deltas + i, count - i, static_cast<uint32_t>(_mm_cvtsi128_si32(carry)), out + i);
+        }
+
+        __attribute__((target("avx2")))
+        inline void prefixSumAVX2(const uint32_t *deltas, size_t count, uint32_t base, uint32_t *out) {
+            const __m256i broadcast_lane0 = _mm256_set1_epi32(3);
+            const __m256i broadcast_last = _mm256_set1_epi32(7);
+            __m256i carry = _mm256_set1_epi32(static_cast<int>(base));
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(deltas + i));
+                // prefix sums inside both 128 bit lanes
+                x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+                x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+                // propagate the sum of the lower lane into the upper lane
+                __m256i lower_sum = _mm256_permutevar8x32_epi32(x, broadcast_lane0);
+                x = _mm256_add_epi32(x, _mm256_blend_epi32(_mm256_setzero_si256(), lower_sum, 0xF0));
+                x = _mm256_add_epi32(x, carry);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), x);
+                carry = _mm256_permutevar8x32_epi32(x, broadcast_last);
+            }
+            prefixSumSSE2(deltas + i, count - i, static_cast<uint32_t>(_mm256_extract_epi32(carry, 0)), out + i);
+        }
+#endif
+    } // namespace detail
+
+    /*! \brief computes out[i] = base + deltas[0] + ... + deltas[i] for all i < count
+     *  \details 32 bit values are summed with AVX2 or SSE2 if available, all other types with a scalar loop. The
+     *  arithmetic wraps around, so U has to be an unsigned integral type.*/
+    template<class U>
+    inline void prefixSum(const U *deltas, size_t count, U base, U *out) {
+        static_assert(std::is_unsigned_v<U>, "prefix sums are computed with wrap-around arithmetic");
+#ifdef COGADB_X86_SIMD
+        if constexpr(sizeof(U) == sizeof(uint32_t)) {
+            if (cpuSupportsAVX2())
+                detail::prefixSumAVX2(reinterpret_cast<const uint32_t *>(deltas), count, base,
+                                      reinterpret_cast<uint32_t *>(out));
+            else
+                detail::prefixSumSSE2(reinterpret_cast<const uint32_t *>(deltas), count, base,
+                                      reinterpret_cast<uint32_t *>(out));
+            return;
+        }
+#endif
+        detail::prefixSumScalar(deltas, count, base, out);
+    }
+
+} // namespace CoGaDB
@@ -1,21 +1,31 @@
 #pragma once
 
+#include "bit_packed_vector.hpp"
 #include "compressed_column.hpp"
 #include "core/global_definitions.hpp"
-#include <map>
-#include "cereal/types/map.hpp"
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+#include "cereal/types/vector.hpp"
+#include <algorithm>
 
 namespace CoGaDB {
 
     /*!
      *  \brief     This class represents a dictionary compressed column with type T, is the base class for all
      * compressed typed column classes.
+     *  \details   The dictionary is a dense array indexed by code. A hash index from value to code is kept alongside,
+     * so encoding a value is an expected O(1) operation. Codes that are no longer referenced by any row are recycled.
+     * The codes of the rows are bit-packed with the minimal bit width for the current dictionary size.
+     * An order-preserving column keeps the order of the codes equal to the order of the values (re-encoding lazily
+     * before a predicate is evaluated), so EQUAL, LESSER and GREATER selections are evaluated on the codes only.
      */
     template<class T>
     class DictionaryCompressedColumn final : public CompressedColumn<T> {
     public:
         /***************** constructors and destructor *****************/
-        explicit DictionaryCompressedColumn(const std::string &name);
+        explicit DictionaryCompressedColumn(const std::string &name, bool order_preserving = false);
 
         ~DictionaryCompressedColumn() final;
 
@@ -49,136 +59,433 @@ namespace CoGaDB {
         [[nodiscard]] virtual std::unique_ptr<ColumnBase> copy() const;
 
          void store(const std::string &path) final;
-        void load(const std::string &path) final; 
+        void load(const std::string &path) final;
 
         T operator[](int index) final;
 
+        /*! \brief unpacks the codes chunk by chunk and looks them up in the dictionary*/
+        void decompress(TID begin, TID end, T *out) const final;
+
+        /*! \brief ranks the dictionary and counting sorts the rows by the ranks of their codes*/
+        PositionList sort(SortOrder order) final;
+
+        /*! \brief joins on the codes if join_column is dictionary compressed as well*/
+        PositionListPair hash_join(ColumnBase &join_column) final;
+
+        /*! \brief joins on the codes if join_column is dictionary compressed as well*/
+        PositionListPair nested_loop_join(ColumnBase &join_column) final;
+
+        /*! \brief returns true if the codes are kept in the same order as the values*/
+        [[nodiscard]] bool isOrderPreserving() const noexcept { return order_preserving; }
+
         /**
          * @brief Serialization method called by Cereal. Implement this method in your compressed columns to get serialization working.
          */
         template<class Archive>
         void serialize(Archive &archive) {
-            //TODO: implement
             archive(dic, values);// serialize things by passing them to the archive
         }
 
+    protected:
+        /*! \brief evaluates the predicate once on the dictionary, the returned scan works on the codes of the rows only*/
+        typename ColumnBaseTyped<T>::RangeSelection prepareSelection(const T &value, ValueComparator comp) final;
+
+        /*! \brief transforms the dictionary entries only, codes of entries that become equal are merged*/
+        void applyScalar(ColumnAlgebraOperation op, const T &value) final;
+
     private:
-        std::map<int, T> dic;
-        std::vector<int> values;   
+        /*! \brief returns the code of value, adds value to the dictionary if necessary and counts the new reference*/
+        int acquireCode(const T &value);
+
+        /*! \brief drops one reference to code, the code is recycled when it is not referenced anymore*/
+        void releaseCode(int code);
+
+        /*! \brief rebuilds the hash index, the reference counts and the free codes from dic and values*/
+        void rebuildIndex();
+
+        /*! \brief re-encodes the column with a sorted dictionary without unused codes*/
+        void sortDictionary();
+
+        /*! \brief equi-joins the codes of both columns after matching both dictionaries once
+         * \details the result is ordered like the result of a nested loop join*/
+        PositionListPair joinCodes(const DictionaryCompressedColumn<T> &join_column) const;
+
+        /*! \brief returns a scan emitting the tids of all rows whose code satisfies the predicate*/
+        template<class CodePredicate>
+        typename ColumnBaseTyped<T>::RangeSelection scanCodes(CodePredicate predicate) const;
+
+        bool order_preserving;
+        /*! true if the order of the codes is the order of their values*/
+        bool sorted_codes = true;
+
+        /*! dictionary, the value of code c is stored at dic[c]*/
+        std::vector<T> dic;
+        /*! hash index from value to code*/
+        std::unordered_map<T, int> codes;
+        /*! number of rows referencing each code*/
+        std::vector<unsigned int> code_counts;
+        /*! codes not referenced by any row, which are reused before the dictionary grows*/
+        std::vector<int> free_codes;
+        /*! bit-packed codes of the rows*/
+        BitPackedVector values;
     };
 
     /***************** Start of Implementation Section ******************/
 
     template<class T>
-    DictionaryCompressedColumn<T>::DictionaryCompressedColumn(const std::string &name) : CompressedColumn<T>(name), dic(), values() {
-        //TODO: implement
+    DictionaryCompressedColumn<T>::DictionaryCompressedColumn(const std::string &name, bool order_preserving)
+            : CompressedColumn<T>(name), order_preserving(order_preserving), dic(), codes(), code_counts(), free_codes(), values() {
     }
 
     template<class T>
     DictionaryCompressedColumn<T>::~DictionaryCompressedColumn() = default;
 
     template<class T>
-    void DictionaryCompressedColumn<T>::insert(const ColumnType &new_Value) {
-        //TODO: implement
-        T new_value = std::get<T>(new_Value);
-        this->insert(new_value);                    //an eigentliche insert-Funktion übergeben                
-        return;
+    int DictionaryCompressedColumn<T>::acquireCode(const T &value) {
+        auto it = codes.find(value);
+        if (it != codes.end()) {                                                //falls Wert in Wörterbuch enthalten
+            code_counts[it->second]++;
+            return it->second;
+        }
+        int code;
+        //ein ordnungserhaltendes Wörterbuch hängt größere Werte hinten an, statt freie Codes zu verwenden
+        bool append = free_codes.empty() || (order_preserving && (dic.empty() || dic.back() < value));
+        if (!append) {                                                          //freien Code wiederverwenden
+            code = free_codes.back();
+            free_codes.pop_back();
+            dic[code] = value;
+            code_counts[code] = 1;
+        } else {                                                                //neuen Wörterbucheintrag anlegen
+            code = static_cast<int>(dic.size());
+            dic.push_back(value);
+            code_counts.push_back(1);
+        }
+        codes.emplace(value, code);
+        if (sorted_codes) {
+            sorted_codes = (code == 0 || dic[code - 1] < value) && (code + 1 >= static_cast<int>(dic.size()) || value < dic[code + 1]);
+        }
+        return code;
     }
 
     template<class T>
-    void DictionaryCompressedColumn<T>::insert(const T &new_value) {
-        //TODO: implement
-        for (auto iterator = dic.begin(); iterator != dic.end(); ++iterator) {
-                if(iterator->second == new_value) {                                      //falls Wert in Wörterbuch enthalten
-                    int code;
-                    code = iterator->first;                                            //Wörterbucheintrag holen
-                    values.push_back(code);                                            //Eintrag am Ende der Daten anfügen
-                    return;
+    void DictionaryCompressedColumn<T>::releaseCode(int code) {
+        if (--code_counts[code] == 0) {                                         //falls Code nicht mehr verwendet wird
+            codes.erase(dic[code]);
+            free_codes.push_back(code);
+        }
+    }
+
+    template<class T>
+    void DictionaryCompressedColumn<T>::rebuildIndex() {
+        codes.clear();
+        free_codes.clear();
+        code_counts.assign(dic.size(), 0);
+        for (size_t i = 0; i < values.size(); i++) {
+            code_counts[values[i]]++;
+        }
+        for (int code = static_cast<int>(dic.size()) - 1; code >= 0; --code) {
+            if (code_counts[code] == 0) {
+                free_codes.push_back(code);
+            } else {
+                codes.emplace(dic[code], code);
+            }
+        }
+        sorted_codes = std::adjacent_find(dic.begin(), dic.end(), [](const T &a, const T &b) { return !(a < b); }) == dic.end();
+    }
+
+    template<class T>
+    void DictionaryCompressedColumn<T>::sortDictionary() {
+        std::vector<uint32_t> used;
+        for (uint32_t code = 0; code < dic.size(); code++) {
+            if (code_counts[code] > 0)
+                used.push_back(code);
+        }
+        std::sort(used.begin(), used.end(), [this](uint32_t a, uint32_t b) { return dic[a] < dic[b]; });
+
+        std::vector<uint32_t> new_code(dic.size());
+        std::vector<T> sorted_dic;
+        std::vector<unsigned int> sorted_counts;
+        sorted_dic.reserve(used.size());
+        sorted_counts.reserve(used.size());
+        for (uint32_t i = 0; i < used.size(); i++) {
+            new_code[used[i]] = i;
+            sorted_dic.push_back(std::move(dic[used[i]]));
+            sorted_counts.push_back(code_counts[used[i]]);
+        }
+
+        BitPackedVector recoded(BitPackedVector::requiredBits(used.empty() ? 0 : used.size() - 1));
+        recoded.reserve(values.size());
+        for (size_t i = 0; i < values.size(); i++) {
+            recoded.push_back(new_code[values[i]]);
+        }
+
+        values = std::move(recoded);
+        dic = std::move(sorted_dic);
+        code_counts = std::move(sorted_counts);
+        free_codes.clear();
+        codes.clear();
+        for (int code = 0; code < static_cast<int>(dic.size()); code++) {
+            codes.emplace(dic[code], code);
+        }
+        sorted_codes = true;
+    }
+
+    template<class T>
+    template<class CodePredicate>
+    typename ColumnBaseTyped<T>::RangeSelection DictionaryCompressedColumn<T>::scanCodes(CodePredicate predicate) const {
+        return [this, predicate](TID begin, TID end, PositionList &result_tids) {
+            constexpr TID CHUNK_SIZE = 1024;
+            uint32_t chunk[CHUNK_SIZE];
+            for (TID chunk_begin = begin; chunk_begin < end; chunk_begin += CHUNK_SIZE) {
+                TID chunk_end = std::min(chunk_begin + CHUNK_SIZE, end);
+                values.unpack(chunk_begin, chunk_end, chunk);
+                for (TID i = 0; i < chunk_end - chunk_begin; i++) {
+                    if (predicate(chunk[i]))
+                        result_tids.push_back(chunk_begin + i);
                 }
+            }
+        };
+    }
+
+    template<class T>
+    typename ColumnBaseTyped<T>::RangeSelection DictionaryCompressedColumn<T>::prepareSelection(const T &value, const ValueComparator comp) {
+        if (comp == EQUAL) {
+            auto it = codes.find(value);
+            if (it == codes.end())
+                return [](TID, TID, PositionList &) {};
+            auto code = static_cast<uint32_t>(it->second);
+            return scanCodes([code](uint32_t c) { return c == code; });
+        }
+
+        if (order_preserving && !sorted_codes)
+            sortDictionary();
+
+        if (sorted_codes) {
+            //Prädikat in einen Code-Bereich übersetzen
+            if (comp == LESSER) {
+                auto bound = static_cast<uint32_t>(std::lower_bound(dic.begin(), dic.end(), value) - dic.begin());
+                return scanCodes([bound](uint32_t c) { return c < bound; });
+            }
+            auto bound = static_cast<uint32_t>(std::upper_bound(dic.begin(), dic.end(), value) - dic.begin());
+            return scanCodes([bound](uint32_t c) { return c >= bound; });
+        }
+
+        //Prädikat einmal pro Wörterbucheintrag auswerten
+        auto qualifies = std::make_shared<std::vector<char>>(dic.size(), 0);
+        for (size_t code = 0; code < dic.size(); code++) {
+            (*qualifies)[code] = comp == LESSER ? dic[code] < value : value < dic[code];
+        }
+        return scanCodes([qualifies](uint32_t c) { return (*qualifies)[c] != 0; });
+    }
+
+    template<class T>
+    PositionListPair DictionaryCompressedColumn<T>::joinCodes(const DictionaryCompressedColumn<T> &join_column) const {
+        constexpr TID CHUNK_SIZE = 1024;
+        uint32_t chunk[CHUNK_SIZE];
+
+        //Wörterbücher abgleichen: eigener Code -> Code der anderen Spalte, -1 falls der Wert dort fehlt
+        std::vector<int> code_map(dic.size(), -1);
+        if (codes.size() <= join_column.codes.size()) {
+            for (const auto &entry: codes) {
+                auto it = join_column.codes.find(entry.first);
+                if (it != join_column.codes.end())
+                    code_map[entry.second] = it->second;
+            }
+        } else {
+            for (const auto &entry: join_column.codes) {
+                auto it = codes.find(entry.first);
+                if (it != codes.end())
+                    code_map[it->second] = entry.second;
+            }
         }
-            if(dic.begin() == dic.end()) {
-                values.push_back(1);
-                dic.insert({1, new_value});
-                return;
+
+        //tids der anderen Spalte nach Code gruppieren, die Gruppengrößen sind die Referenzzähler
+        std::vector<size_t> offsets(join_column.dic.size() + 1, 0);
+        for (size_t code = 0; code < join_column.dic.size(); code++)
+            offsets[code + 1] = offsets[code] + join_column.code_counts[code];
+        std::vector<size_t> write_positions(offsets.begin(), offsets.end() - 1);
+        std::vector<TID> tids(join_column.values.size());
+        for (TID chunk_begin = 0; chunk_begin < join_column.values.size(); chunk_begin += CHUNK_SIZE) {
+            TID chunk_end = std::min<TID>(chunk_begin + CHUNK_SIZE, join_column.values.size());
+            join_column.values.unpack(chunk_begin, chunk_end, chunk);
+            for (TID i = 0; i < chunk_end - chunk_begin; i++)
+                tids[write_positions[chunk[i]]++] = chunk_begin + i;
+        }
+
+        //eigene Codes abbilden und mit den Gruppen verbinden
+        PositionListPair join_tids;
+        for (TID chunk_begin = 0; chunk_begin < values.size(); chunk_begin += CHUNK_SIZE) {
+            TID chunk_end = std::min<TID>(chunk_begin + CHUNK_SIZE, values.size());
+            values.unpack(chunk_begin, chunk_end, chunk);
+            for (TID i = 0; i < chunk_end - chunk_begin; i++) {
+                int code = code_map[chunk[i]];
+                if (code < 0)
+                    continue;
+                for (size_t j = offsets[code]; j < offsets[code + 1]; j++) {
+                    join_tids.first.push_back(chunk_begin + i);
+                    join_tids.second.push_back(tids[j]);
+                }
             }
-            else {                                                                   //falls Wert nicht in Wörterbuch enthalten
-                int lastCode = dic.rbegin()->first;
-                values.push_back(lastCode+1);                                       //Neuen Wörterbucheintrag am Ende der Daten anfügen
-                dic.insert({lastCode+1, new_value});                                //Neuen Wörterbucheintrag in Wörterbuch schreiben
-                return; 
+        }
+        return join_tids;
+    }
+
+    template<class T>
+    PositionList DictionaryCompressedColumn<T>::sort(SortOrder order) {
+        //Rang jedes Codes in der Sortierreihenfolge bestimmen, bei sortierten Codes ist der Code selbst der Rang
+        std::vector<uint32_t> rank(dic.size());
+        std::iota(rank.begin(), rank.end(), 0);
+        if (!sorted_codes) {
+            std::vector<uint32_t> used;
+            for (uint32_t code = 0; code < dic.size(); code++) {
+                if (code_counts[code] > 0)
+                    used.push_back(code);
             }
+            std::sort(used.begin(), used.end(), [this](uint32_t a, uint32_t b) { return dic[a] < dic[b]; });
+            for (uint32_t i = 0; i < used.size(); i++)
+                rank[used[i]] = i;
+        }
+
+        //Zählsortierung: die Anzahl der Zeilen je Rang sind die Referenzzähler
+        std::vector<size_t> offsets(dic.size() + 1, 0);
+        for (uint32_t code = 0; code < dic.size(); code++)
+            offsets[rank[code] + 1] += code_counts[code];
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        constexpr TID CHUNK_SIZE = 1024;
+        uint32_t chunk[CHUNK_SIZE];
+        PositionList ids(values.size());
+        for (TID chunk_begin = 0; chunk_begin < values.size(); chunk_begin += CHUNK_SIZE) {
+            TID chunk_end = std::min<TID>(chunk_begin + CHUNK_SIZE, values.size());
+            values.unpack(chunk_begin, chunk_end, chunk);
+            for (TID i = 0; i < chunk_end - chunk_begin; i++)
+                ids[offsets[rank[chunk[i]]]++] = chunk_begin + i;
+        }
+
+        //absteigend ist die exakte Umkehrung der aufsteigenden Reihenfolge (Wert, tid)
+        if (order == DESCENDING)
+            std::reverse(ids.begin(), ids.end());
+        return ids;
     }
-    
+
+    template<class T>
+    PositionListPair DictionaryCompressedColumn<T>::hash_join(ColumnBase &join_column) {
+        if (auto *dictionary_column = dynamic_cast<DictionaryCompressedColumn<T> *>(&join_column))
+            return joinCodes(*dictionary_column);
+        return ColumnBaseTyped<T>::hash_join(join_column);
+    }
+
+    template<class T>
+    PositionListPair DictionaryCompressedColumn<T>::nested_loop_join(ColumnBase &join_column) {
+        if (auto *dictionary_column = dynamic_cast<DictionaryCompressedColumn<T> *>(&join_column))
+            return joinCodes(*dictionary_column);
+        return ColumnBaseTyped<T>::nested_loop_join(join_column);
+    }
+
+    template<class T>
+    void DictionaryCompressedColumn<T>::applyScalar(ColumnAlgebraOperation op, const T &value) {
+        for (auto &entry: dic) {
+            entry = applyOperation(op, entry, value);
+        }
+
+        //Codes von Einträgen mit gleichem Ergebnis auf einen Code abbilden
+        std::unordered_map<T, int> transformed_codes;
+        std::vector<uint32_t> new_code(dic.size());
+        bool merged = false;
+        for (int code = 0; code < static_cast<int>(dic.size()); code++) {
+            if (code_counts[code] == 0)
+                continue;
+            auto result = transformed_codes.emplace(dic[code], code);
+            new_code[code] = result.first->second;
+            merged |= !result.second;
+        }
+
+        if (merged) {                                                           //Zeilen umkodieren
+            for (size_t i = 0; i < values.size(); i++)
+                values.set(i, new_code[values[i]]);
+            rebuildIndex();
+        } else {
+            codes = std::move(transformed_codes);
+            sorted_codes = std::adjacent_find(dic.begin(), dic.end(), [](const T &a, const T &b) { return !(a < b); }) == dic.end();
+        }
+    }
+
+    template<class T>
+    void DictionaryCompressedColumn<T>::insert(const ColumnType &new_Value) {
+        T new_value = std::get<T>(new_Value);
+        this->insert(new_value);                    //an eigentliche insert-Funktion übergeben
+        return;
+    }
+
+    template<class T>
+    void DictionaryCompressedColumn<T>::insert(const T &new_value) {
+        values.push_back(acquireCode(new_value));                               //Eintrag am Ende der Daten anfügen
+    }
+
 
     template<typename T>
     template<typename InputIterator>
     void DictionaryCompressedColumn<T>::insert(InputIterator first, InputIterator last) {
-        //TODO: implement
+        if constexpr(std::is_base_of_v<std::forward_iterator_tag,
+                                       typename std::iterator_traits<InputIterator>::iterator_category>) {
+            values.reserve(values.size() + std::distance(first, last));
+        }
+        //Wörterbuch in einem Durchlauf aufbauen, Wiederholungen des letzten Werts ohne Hash-Lookup kodieren
         for (InputIterator i = first; i != last; ++i){
-            this->insert(i);                                    //an eigentliche insert-Funktion übergeben
+            if (!values.empty() && dic[values.back()] == *i) {
+                code_counts[values.back()]++;
+                values.push_back(values.back());
+            } else {
+                values.push_back(acquireCode(*i));
+            }
         }
         return;
     }
 
     template<class T>
     ColumnType DictionaryCompressedColumn<T>::get(TID tid) {
-        //TODO: implement
-        int code = values[tid];                     //Wörterbucheintrag an Stelle tid holen
-        T value;
-        auto it = dic.find(code);                   //Wert holen
-        value = it->second;                         
-        return value;                               //Wert zurückgeben
+        if (tid >= values.size()) {
+            throw std::out_of_range("DictionaryCompressedColumn::get(): invalid tid " + std::to_string(tid));
+        }
+        return dic[values[tid]];                    //Wert zurückgeben
     }
 
     template<class T>
     std::string DictionaryCompressedColumn<T>::print() const noexcept {
-        //TODO: implement
-        T value;
-        for (unsigned int i = 0; i < values.size(); i++){
-            auto it = dic.find(i);             
-            value = it->second;               
-            std::cout << value << '\n';
+        std::string str = "| " + this->name_ + " |\n________________________\n";
+        for (size_t i = 0; i < values.size(); i++) {
+            uint32_t code = values[i];
+            if constexpr(std::is_same_v<std::string, T>)
+                str.append("| " + dic[code] + " |\n");
+            else
+                str.append("| " + std::to_string(dic[code]) + " |\n");
         }
-        return {};
+        return str;
     }
 
     template<class T>
     size_t DictionaryCompressedColumn<T>::size() const noexcept {
-        //TODO: implement
         return values.size();
     }
 
     template<class T>
     std::unique_ptr<ColumnBase> DictionaryCompressedColumn<T>::copy() const {
-        //TODO: implement
         return std::make_unique<DictionaryCompressedColumn<T>>(*this);
     }
 
     template<class T>
     void DictionaryCompressedColumn<T>::update(TID tid, const ColumnType &new_value) {
-        //TODO: implement
-        if (values.size() > tid) {  
-        for (auto iterator = dic.begin(); iterator != dic.end(); ++iterator) {
-                if(iterator->second == std::get<T>(new_value)) {     //Wenn Code schon vorhanden                    
-                int code;
-                code = iterator->first;
-                values[tid] = code;                     //Alten Code durch "neuen" ersetzen
-                return;
-                }   
-        }                                        //Wenn Wert nicht Wörterbuch vorhanden  
-        int lastCode = dic.rbegin()->first;
-        values[tid] = lastCode+1;
-        T new_value_ = std::get<T>(new_value);                 //Neuen Wörterbucheintrag am Ende der Daten anfügen
-        dic.insert({lastCode+1, new_value_});                    //Neuen Wörterbucheintrag in Wörterbuch schreiben
-        return;
+        if (values.size() > tid) {
+            int code = acquireCode(std::get<T>(new_value));  //zuerst neuen Code holen, damit ein gleicher Wert nicht freigegeben wird
+            releaseCode(values[tid]);
+            values.set(tid, code);                            //Alten Code durch neuen ersetzen
         }
         return;
     }
 
     template<class T>
     void DictionaryCompressedColumn<T>::update(PositionList &tid, const ColumnType &new_value) {
-        //TODO: implement
-        for (unsigned int tid_: tid) {    
+        for (unsigned int tid_: tid) {
             this->update(tid_, new_value);               //an eigentliche update-Funktion übergeben
         }
         return;
@@ -186,50 +493,40 @@ namespace CoGaDB {
 
     template<class T>
     void DictionaryCompressedColumn<T>::remove(TID tid) {
-        //TODO: implement
         if(values.size() > tid){
-            auto code = values[tid];
-            values.erase(values.begin()+(tid));
-            if(std::find(values.begin(), values.end(), code) != values.end())                   //Wenn Wert noch in Wörterbuch vorhanden
-            {   
-                return; 
-            }
-            else                                                                                //falls code nicht mehr verwendet wird
-            {   
-                auto it = dic.find(code);                 
-                dic.erase(it);
-                return;
-            }
+            releaseCode(values[tid]);
+            values.erase(tid);
         }
         return;
     }
 
     template<class T>
     void DictionaryCompressedColumn<T>::remove(PositionList &tid) {
-        //TODO: implement
-        for (unsigned int tid_: tid) {    
-            this->remove(tid_);               //an eigentliche remove-Funktion übergeben
+        for (auto rit = tid.rbegin(); rit != tid.rend(); ++rit) {
+            this->remove(*rit);               //von hinten entfernen, damit sich die übrigen tids nicht verschieben
         }
         return;
     }
 
     template<class T>
     void DictionaryCompressedColumn<T>::clearContent() {
-        //TODO: implement
         dic.clear();
+        codes.clear();
+        code_counts.clear();
+        free_codes.clear();
         values.clear();
+        sorted_codes = true;
         return;
     }
 
      template<class T>
     void DictionaryCompressedColumn<T>::store(const std::string &path) {
-        //TODO: implement
         std::string path_(path);
         path_ += this->name_;
 
         std::ofstream outfile(path_.c_str(), std::ofstream::binary | std::ofstream::out | std::ofstream::trunc);
         assert(outfile.is_open());
-        cereal::PortableBinaryOutputArchive oarchive(outfile); 
+        cereal::PortableBinaryOutputArchive oarchive(outfile);
         oarchive(values);
 
         outfile.flush();
@@ -240,13 +537,12 @@ namespace CoGaDB {
         cereal::PortableBinaryOutputArchive oarchive2(outfile2);
         oarchive2(dic);
 
-        outfile2.flush();  
+        outfile2.flush();
         return;
     }
 
     template<class T>
     void DictionaryCompressedColumn<T>::load(const std::string &path) {
-        //TODO: implement
         std::string path_(path);
         path_ += this->name_;
 
@@ -257,27 +553,42 @@ namespace CoGaDB {
         path_ += "dic";
         std::ifstream infile2(path_.c_str(), std::ifstream::binary | std::ifstream::in);
         cereal::PortableBinaryInputArchive ia2(infile2);
-        ia2(dic);  
+        ia2(dic);
+
+        rebuildIndex();
         return;
-    } 
+    }
 
 
     template<class T>
     T DictionaryCompressedColumn<T>::operator[](const int index) {
-        //TODO: implement
-        int code = values[index];                    //Wörterbucheintrag an Stelle tid holen
-        T value;
-        auto it = dic.find(code);                   //Wert holen
-        value = it->second;                         
-        return value;                               //Wert zurückgeben                   
+        return dic[values[index]];                   //Wert zurückgeben
+    }
+
+    template<class T>
+    void DictionaryCompressedColumn<T>::decompress(TID begin, TID end, T *out) const {
+        constexpr TID CHUNK_SIZE = 1024;
+        uint32_t chunk[CHUNK_SIZE];
+        for (TID chunk_begin = begin; chunk_begin < end; chunk_begin += CHUNK_SIZE) {
+            TID chunk_end = std::min(chunk_begin + CHUNK_SIZE, end);
+            values.unpack(chunk_begin, chunk_end, chunk);
+            for (TID i = 0; i < chunk_end - chunk_begin; i++)
+                *out++ = dic[chunk[i]];
+        }
     }
 
     template<class T>
     size_t DictionaryCompressedColumn<T>::getSizeInBytes() const noexcept {
-        //TODO: implement
-        return values.capacity() * sizeof(int) + dic.size() * (sizeof(int) + sizeof(T));
+        // dictionary with reference counts, free codes and the hash index, which holds a second copy of every value
+        size_t bytes = values.getSizeInBytes() + dic.size() * (sizeof(T) + sizeof(unsigned int)) +
+                       free_codes.size() * sizeof(int) + codes.size() * detail::index_entry_bytes<T>;
+        for (const T &value: dic)
+            bytes += detail::heapBytes(value);
+        for (const auto &entry: codes)
+            bytes += detail::heapBytes(entry.first);
+        return bytes;
     }
 
     /***************** End of Implementation Section ******************/
 
-}// namespace CoGaDB
\ No newline at end of file
+}// namespace CoGaDB
@@ -0,0 +1,556 @@
+#pragma once
+
+#include "compressed_column.hpp"
+#include "frame_of_reference_kernels.hpp"
+#include "core/global_definitions.hpp"
+#include "core/selection_kernels.hpp"
+#include "cereal/types/vector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+
+namespace CoGaDB {
+
+    /*!
+     *  \brief This class represents a frame of reference encoded column with type T (int or float).
+     *  \details The rows are divided into blocks of BLOCK_SIZE values. A block stores a reference and the offsets of its
+     *  values to it with the bit width that minimizes the size of the block (PFOR): values below the reference or too
+     *  far above it are stored as exceptions with their position and patched after unpacking. Floats are encoded via
+     *  an order preserving mapping of their bit patterns. The rows behind the last full block are kept unpacked.
+     *  Selections skip blocks whose value range cannot match and accept blocks whose value range matches completely.
+     */
+    template<class T>
+    class FrameOfReferenceColumn final : public CompressedColumn<T> {
+        static_assert(std::is_same_v<T, int> || std::is_same_v<T, float>,
+                      "Invalid type: frame of reference encoding supports int and float");
+
+    public:
+        /*! \brief number of values per block*/
+        static constexpr TID BLOCK_SIZE = FOR_BLOCK_SIZE;
+
+        /*! \brief bits an exception occupies: its position in the block and its full value*/
+        static constexpr size_t EXCEPTION_BITS = 8 + 32;
+
+        /***************** constructors and destructor *****************/
+        explicit FrameOfReferenceColumn(const std::string &name);
+
+        ~FrameOfReferenceColumn() final;
+
+        void insert(const ColumnType &new_Value) final;
+
+        void insert(const T &new_value) final;
+
+        template<typename InputIterator>
+        void insert(InputIterator first, InputIterator last);
+
+        void update(TID tid, const ColumnType &new_value) final;
+
+        void update(PositionList &tid, const ColumnType &new_value) final;
+
+        void remove(TID tid) final;
+
+        // assumes tid list is sorted ascending
+        void remove(PositionList &tid) final;
+
+        void clearContent() final;
+
+        ColumnType get(TID tid) final;
+
+        std::string print() const noexcept final;
+
+        [[nodiscard]] size_t size() const noexcept final;
+
+        [[nodiscard]] size_t getSizeInBytes() const noexcept final;
+
+        [[nodiscard]] virtual std::unique_ptr<ColumnBase> copy() const;
+
+        void store(const std::string &path) final;
+
+        void load(const std::string &path) final;
+
+        T operator[](int index) final;
+
+        /*! \brief unpacks whole blocks with SIMD instructions and patches their exceptions*/
+        void decompress(TID begin, TID end, T *out) const final;
+
+        /**
+         * @brief Serialization method called by Cereal. Implement this method in your compressed columns to get serialization working.
+         */
+        template<class Archive>
+        void serialize(Archive &archive) {
+            archive(blocks, packed, exception_positions, exception_keys, tail);
+        }
+
+    protected:
+        /*! \brief decides per block from its minimum and maximum, only blocks that may partially match are unpacked*/
+        typename ColumnBaseTyped<T>::RangeSelection prepareSelection(const T &value, ValueComparator comp) final;
+
+        /*! \brief adding to or subtracting from integers moves the references, all other operations re-encode*/
+        void applyScalar(ColumnAlgebraOperation op, const T &value) final;
+
+    private:
+        struct Block {
+            /*! key every value except the exceptions is stored as offset to*/
+            uint32_t reference;
+            /*! keys of the minimum and the maximum*/
+            uint32_t min;
+            uint32_t max;
+            /*! position of the packed offsets in packed*/
+            uint32_t word_offset;
+            /*! position of the first exception in exception_positions and exception_keys*/
+            uint32_t exception_offset;
+            uint8_t bit_width;
+            uint8_t exception_count;
+
+            template<class Archive>
+            void serialize(Archive &archive) {
+                archive(reference, min, max, word_offset, exception_offset, bit_width, exception_count);
+            }
+        };
+
+        /*! \brief encodes BLOCK_SIZE keys, appends the packed offsets to words and the exceptions to positions and
+         * exception_values, the offsets of the returned block are relative to the previous sizes of these vectors*/
+        static Block encodeBlock(const uint32_t *keys, std::vector<uint32_t> &words, std::vector<uint8_t> &positions,
+                                 std::vector<uint32_t> &exception_values);
+
+        /*! \brief encodes BLOCK_SIZE keys as new last block*/
+        void appendBlock(const uint32_t *keys);
+
+        /*! \brief re-encodes the block with index block from BLOCK_SIZE keys*/
+        void replaceBlock(size_t block, const uint32_t *keys);
+
+        /*! \brief writes the keys of the block with index block to keys*/
+        void decodeBlock(size_t block, uint32_t *keys) const;
+
+        /*! \brief appends keys to the unpacked rows and packs every block that becomes full*/
+        void appendKeys(const std::vector<uint32_t> &keys);
+
+        /*! \brief returns the keys of all rows starting with the block with index first_block*/
+        std::vector<uint32_t> keysFrom(size_t first_block) const;
+
+        /*! \brief drops all rows starting with the block with index first_block*/
+        void truncate(size_t first_block);
+
+        uint32_t keyAt(TID tid) const;
+
+        std::vector<Block> blocks;
+        /*! packed offsets of all blocks*/
+        std::vector<uint32_t> packed;
+        /*! position inside its block and key of every exception, ordered by block and position*/
+        std::vector<uint8_t> exception_positions;
+        std::vector<uint32_t> exception_keys;
+        /*! keys of the rows behind the last full block*/
+        std::vector<uint32_t> tail;
+    };
+
+    /***************** Start of Implementation Section ******************/
+
+    template<class T>
+    FrameOfReferenceColumn<T>::FrameOfReferenceColumn(const std::string &name)
+            : CompressedColumn<T>(name), blocks(), packed(), exception_positions(), exception_keys(), tail() {
+    }
+
+    template<class T>
+    FrameOfReferenceColumn<T>::~FrameOfReferenceColumn() = default;
+
+    template<class T>
+    typename FrameOfReferenceColumn<T>::Block
+    FrameOfReferenceColumn<T>::encodeBlock(const uint32_t *keys, std::vector<uint32_t> &words,
+                                           std::vector<uint8_t> &positions, std::vector<uint32_t> &exception_values) {
+        Block block{};
+        uint32_t sorted[BLOCK_SIZE];
+        std::copy(keys, keys + BLOCK_SIZE, sorted);
+        std::sort(sorted, sorted + BLOCK_SIZE);
+        block.min = sorted[0];
+        block.max = sorted[BLOCK_SIZE - 1];
+
+        // for every bit width, the window [reference, reference + 2^bit_width) covering the most keys is found with
+        // two pointers over the sorted keys, all other keys become exceptions. The smallest encoding wins, so
+        // outliers on both ends of the value range do not widen the offsets of the other values.
+        size_t best_size = std::numeric_limits<size_t>::max();
+        for (unsigned int bit_width = 0; bit_width <= 32; bit_width++) {
+            size_t covered = BLOCK_SIZE;
+            uint32_t reference = sorted[0];
+            if (bit_width < 32) {
+                covered = 0;
+                const uint64_t range = uint64_t(1) << bit_width;
+                for (size_t first = 0, last = 0; first < BLOCK_SIZE; first++) {
+                    while (last < BLOCK_SIZE && uint64_t(sorted[last]) - sorted[first] < range)
+                        last++;
+                    if (last - first > covered) {
+                        covered = last - first;
+                        reference = sorted[first];
+                    }
+                }
+            }
+            size_t size = BLOCK_SIZE * bit_width + (BLOCK_SIZE - covered) * EXCEPTION_BITS;
+            if (size < best_size) {
+                best_size = size;
+                block.bit_width = static_cast<uint8_t>(bit_width);
+                block.reference = reference;
+            }
+        }
+
+        uint32_t offsets[BLOCK_SIZE];
+        block.exception_offset = static_cast<uint32_t>(positions.size());
+        for (size_t i = 0; i < BLOCK_SIZE; i++) {
+            offsets[i] = keys[i] - block.reference;
+            if (keys[i] < block.reference || (block.bit_width < 32 && offsets[i] >> block.bit_width)) {
+                positions.push_back(static_cast<uint8_t>(i));
+                exception_values.push_back(keys[i]);
+                offsets[i] = 0;
+            }
+        }
+        block.exception_count = static_cast<uint8_t>(positions.size() - block.exception_offset);
+
+        block.word_offset = static_cast<uint32_t>(words.size());
+        words.resize(words.size() + 4 * block.bit_width);
+        packBlock(offsets, block.bit_width, words.data() + block.word_offset);
+        return block;
+    }
+
+    template<class T>
+    void FrameOfReferenceColumn<T>::appendBlock(const uint32_t *keys) {
+        blocks.push_back(encodeBlock(keys, packed, exception_positions, exception_keys));
+    }
+
+    template<class T>
+    void FrameOfReferenceColumn<T>::replaceBlock(size_t block, const uint32_t *keys) {
+        std::vector<uint32_t> words;
+        std::vector<uint8_t> positions;
+        std::vector<uint32_t> values;
+        Block new_block = encodeBlock(keys, words, positions, values);
+        const Block &old_block = blocks[block];
+
+        // splice the new encoding in place of the old one and move the following blocks
+        auto word_difference = static_cast<int64_t>(words.size()) - 4 * old_block.bit_width;
+        auto exception_difference = static_cast<int64_t>(positions.size()) - old_block.exception_count;
+        if (word_difference != 0) {
+            auto first = packed.begin() + old_block.word_offset;
+            packed.erase(first, first + 4 * old_block.bit_width);
+            packed.insert(packed.begin() + old_block.word_offset, words.begin(), words.end());
+        } else {
+            std::copy(words.begin(), words.end(), packed.begin() + old_block.word_offset);
+        }
+        auto first_position = exception_positions.begin() + old_block.exception_offset;
+        exception_positions.erase(first_position, first_position + old_block.exception_count);
+        exception_positions.insert(exception_positions.begin() + old_block.exception_offset, positions.begin(), positions.end());
+        auto first_key = exception_keys.begin() + old_block.exception_offset;
+        exception_keys.erase(first_key, first_key + old_block.exception_count);
+        exception_keys.insert(exception_keys.begin() + old_block.exception_offset, values.begin(), values.end());
+
+        new_block.word_offset = old_block.word_offset;
+        new_block.exception_offset = old_block.exception_offset;
+        blocks[block] = new_block;
+        for (size_t b = block + 1; b < blocks.size(); b++) {
+            blocks[b].word_offset = static_cast<uint32_t>(blocks[b].word_offset + word_difference);
+            blocks[b].exception_offset = static_cast<uint32_t>(blocks[b].exception_offset + exception_difference);
+        }
+    }
+
+    template<class T>
+    void FrameOfReferenceColumn<T>::decodeBlock(size_t block, uint32_t *keys) const {
+        const Block &b = blocks[block];
+        unpackBlock(packed.data() + b.word_offset, b.bit_width, b.reference, keys);
+        for (size_t e = b.exception_offset; e < b.exception_offset + b.exception_count; e++)
+            keys[exception_positions[e]] = exception_keys[e];
+    }
+
+    template<class T>
+    void FrameOfReferenceColumn<T>::appendKeys(const std::vector<uint32_t> &keys) {
+        for (uint32_t key: keys) {
+            tail.push_back(key);
+            if (tail.size() == BLOCK_SIZE) {
+                appendBlock(tail.data());
+                tail.clear();
+            }
+        }
+    }
+
+    template<class T>
+    std::vector<uint32_t> FrameOfReferenceColumn<T>::keysFrom(size_t first_block) const {
+        std::vector<uint32_t> keys((blocks.size() - first_block) * BLOCK_SIZE);
+        for (size_t block = first_block; block < blocks.size(); block++)
+            decodeBlock(block, keys.data() + (block - first_block) * BLOCK_SIZE);
+        keys.insert(keys.end(), tail.begin(), tail.end());
+        return keys;
+    }
+
+    template<class T>
+    void FrameOfReferenceColumn<T>::truncate(size_t first_block) {
+        if (first_block < blocks.size()) {
+            packed.resize(blocks[first_block].word_offset);
+            exception_positions.resize(blocks[first_block].exception_offset);
+            exception_keys.resize(blocks[first_block].exception_offset);
+            blocks.resize(first_block);
+        }
+        tail.clear();
+    }
+
+    template<class T>
+    uint32_t FrameOfReferenceColumn<T>::keyAt(TID tid) const {
+        size_t block = tid / BLOCK_SIZE;
+        if (block >= blocks.size())
+            return tail[tid - blocks.size() * BLOCK_SIZE];
+        const Block &b = blocks[block];
+        auto index = static_cast<uint8_t>(tid % BLOCK_SIZE);
+        auto first = exception_positions.begin() + b.exception_offset;
+        auto last = first + b.exception_count;
+        auto exception = std::lower_bound(first, last, index);
+        if (exception != last && *exception == index)
+            return exception_keys[exception - exception_positions.begin()];
+        return extractValue(packed.data() + b.word_offset, b.bit_width, b.reference, index);
+    }
+
+    template<class T>
+    void FrameOfReferenceColumn<T>::insert(const ColumnType &new_Value) {
+        this->insert(std::get<T>(new_Value));
+    }
+
+    template<class T>
+    void FrameOfReferenceColumn<T>::insert(const T &new_value) {
+        tail.push_back(orderedKey(new_value));
+        if (tail.size() == BLOCK_SIZE) {
+            appendBlock(tail.data());
+            tail.clear();
+        }
+    }
+
+    template<typename T>
+    template<typename InputIterator>
+    void FrameOfReferenceColumn<T>::insert(InputIterator first, InputIterator last) {
+        for (InputIterator i = first; i != last; ++i)
+            this->insert(*i);
+    }
+
+    template<class T>
+    void FrameOfReferenceColumn<T>::update(TID tid, const ColumnType &new_value) {
+        if (tid >= size())
+            throw std::out_of_range("FrameOfReferenceColumn::update(): invalid tid " + std::to_string(tid));
+
+        uint32_t key = orderedKey(std::get<T>(new_value));
+        size_t block = tid / BLOCK_SIZE;
+        if (block >= blocks.size()) {
+            tail[tid - blocks.size() * BLOCK_SIZE] = key;
+            return;
+        }
+        uint32_t keys[BLOCK_SIZE];
+        decodeBlock(block, keys);
+        keys[tid % BLOCK_SIZE] = key;
+        replaceBlock(block, keys);
+    }
+
+    template<class T>
+    void FrameOfReferenceColumn<T>::update(PositionList &tids, const ColumnType &new_value) {
+        for (TID tid: tids)
+            update(tid, new_value);
+    }
+
+    template<class T>
+    void FrameOfReferenceColumn<T>::remove(TID tid) {
+        if (tid >= size())
+            throw std::out_of_range("FrameOfReferenceColumn::remove(): invalid tid " + std::to_string(tid));
+
+        // all following rows move to the front, so every block starting with the one of tid is re-encoded
+        size_t block = tid / BLOCK_SIZE;
+        std::vector<uint32_t> keys = keysFrom(block);
+        keys.erase(keys.begin() + (tid - block * BLOCK_SIZE));
+        truncate(block);
+        appendKeys(keys);
+    }
+
+    template<class T>
+    void FrameOfReferenceColumn<T>::remove(PositionList &tids) {
+        if (tids.empty())
+            return;
+        size_t first_block = tids.front() / BLOCK_SIZE;
+        std::vector<uint32_t> keys = keysFrom(first_block);
+        std::vector<uint32_t> remaining;
+        remaining.reserve(keys.size());
+        auto next = tids.begin();
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (next != tids.end() && *next == first_block * BLOCK_SIZE + i) {
+                ++next;
+                continue;
+            }
+            remaining.push_back(keys[i]);
+        }
+        truncate(first_block);
+        appendKeys(remaining);
+    }
+
+    template<class T>
+    void FrameOfReferenceColumn<T>::clearContent() {
+        blocks.clear();
+        packed.clear();
+        exception_positions.clear();
+        exception_keys.clear();
+        tail.clear();
+    }
+
+    template<class T>
+    ColumnType FrameOfReferenceColumn<T>::get(TID tid) {
+        if (tid >= size())
+            throw std::out_of_range("FrameOfReferenceColumn::get(): invalid tid " + std::to_string(tid));
+        return (*this)[tid];
+    }
+
+    template<class T>
+    T FrameOfReferenceColumn<T>::operator[](const int index) {
+        return fromOrderedKey<T>(keyAt(static_cast<TID>(index)));
+    }
+
+    template<class T>
+    void FrameOfReferenceColumn<T>::decompress(TID begin, TID end, T *out) const {
+        uint32_t keys[BLOCK_SIZE];
+        for (TID tid = begin; tid < end;) {
+            size_t block = tid / BLOCK_SIZE;
+            TID block_begin = static_cast<TID>(block * BLOCK_SIZE);
+            TID last = std::min<TID>(end, block_begin + BLOCK_SIZE);
+            const uint32_t *block_keys = keys;
+            if (block < blocks.size())
+                decodeBlock(block, keys);
+            else
+                block_keys = tail.data();
+            for (; tid < last; tid++)
+                *out++ = fromOrderedKey<T>(block_keys[tid - block_begin]);
+        }
+    }
+
+    template<class T>
+    typename ColumnBaseTyped<T>::RangeSelection FrameOfReferenceColumn<T>::prepareSelection(const T &value, const ValueComparator comp) {
+        return [this, value, comp](TID begin, TID end, PositionList &result_tids) {
+            uint32_t keys[BLOCK_SIZE];
+            T values[BLOCK_SIZE];
+            for (TID block_begin = begin - begin % BLOCK_SIZE; block_begin < end; block_begin += BLOCK_SIZE) {
+                TID first = std::max(begin, block_begin), last = std::min<TID>(end, block_begin + BLOCK_SIZE);
+                size_t block = block_begin / BLOCK_SIZE;
+                const uint32_t *block_keys = keys;
+                if (block < blocks.size()) {
+                    // the bounds are compared like the values, NaN bounds never decide a block completely
+                    T min = fromOrderedKey<T>(blocks[block].min), max = fromOrderedKey<T>(blocks[block].max);
+                    bool ordered = true;
+                    if constexpr(std::is_same_v<T, float>)
+                        ordered = !std::isnan(min) && !std::isnan(max);
+                    bool none, all;
+                    if (comp == EQUAL) {
+                        none = value < min || max < value;
+                        all = ordered && min == value && max == value;
+                    } else if (comp == LESSER) {
+                        none = value <= min;
+                        all = ordered && max < value;
+                    } else {
+                        none = max <= value;
+                        all = ordered && value < min;
+                    }
+                    if (none)
+                        continue;
+                    if (all) {
+                        size_t offset = result_tids.size();
+                        result_tids.resize(offset + (last - first));
+                        std::iota(result_tids.begin() + offset, result_tids.end(), first);
+                        continue;
+                    }
+                    decodeBlock(block, keys);
+                } else {
+                    block_keys = tail.data();
+                }
+                for (TID i = first - block_begin; i < last - block_begin; i++)
+                    values[i] = fromOrderedKey<T>(block_keys[i]);
+                size_t offset = result_tids.size();
+                result_tids.resize(offset + (last - first));
+                TID *out = result_tids.data() + offset;
+                size_t count = selectValues(values, first - block_begin, last - block_begin, value, comp, out);
+                for (size_t i = 0; i < count; i++)
+                    out[i] += block_begin;
+                result_tids.resize(offset + count);
+            }
+        };
+    }
+
+    template<class T>
+    void FrameOfReferenceColumn<T>::applyScalar(ColumnAlgebraOperation op, const T &value) {
+        if constexpr(std::is_same_v<T, int>) {
+            if (op == ADD || op == SUB) {
+                // keys move by the same amount as the values, unless a value leaves the range of int
+                int64_t shift = op == ADD ? int64_t(value) : -int64_t(value);
+                auto fits = [shift](uint32_t key) {
+                    int64_t moved = fromOrderedKey<int>(key) + shift;
+                    return moved >= std::numeric_limits<int>::min() && moved <= std::numeric_limits<int>::max();
+                };
+                bool all_fit = std::all_of(tail.begin(), tail.end(), fits);
+                for (const Block &block: blocks)
+                    all_fit = all_fit && fits(block.min) && fits(block.max);
+                if (all_fit) {
+                    auto delta = static_cast<uint32_t>(shift);
+                    for (Block &block: blocks) {
+                        block.reference += delta;
+                        block.min += delta;
+                        block.max += delta;
+                    }
+                    for (uint32_t &key: exception_keys)
+                        key += delta;
+                    for (uint32_t &key: tail)
+                        key += delta;
+                    return;
+                }
+            }
+        }
+        ColumnBaseTyped<T>::applyScalar(op, value);
+    }
+
+    template<class T>
+    std::string FrameOfReferenceColumn<T>::print() const noexcept {
+        std::string str = "| " + this->name_ + " |\n________________________\n";
+        std::vector<T> values(size());
+        decompress(0, static_cast<TID>(values.size()), values.data());
+        for (const T &value: values)
+            str.append("| " + std::to_string(value) + " |\n");
+        return str;
+    }
+
+    template<class T>
+    size_t FrameOfReferenceColumn<T>::size() const noexcept {
+        return blocks.size() * BLOCK_SIZE + tail.size();
+    }
+
+    template<class T>
+    size_t FrameOfReferenceColumn<T>::getSizeInBytes() const noexcept {
+        return blocks.size() * sizeof(Block) + packed.size() * sizeof(uint32_t) +
+               exception_positions.size() * sizeof(uint8_t) + exception_keys.size() * sizeof(uint32_t) +
+               tail.size() * sizeof(uint32_t);
+    }
+
+    template<class T>
+    std::unique_ptr<ColumnBase> FrameOfReferenceColumn<T>::copy() const {
+        return std::make_unique<FrameOfReferenceColumn<T>>(*this);
+    }
+
+    template<class T>
+    void FrameOfReferenceColumn<T>::store(const std::string &path) {
+        std::string path_(path);
+        path_ += this->name_;
+
+        std::ofstream outfile(path_.c_str(), std::ofstream::binary | std::ofstream::out | std::ofstream::trunc);
+        assert(outfile.is_open());
+        cereal::PortableBinaryOutputArchive oarchive(outfile);
+        oarchive(*this);
+    }
+
+    template<class T>
+    void FrameOfReferenceColumn<T>::load(const std::string &path) {
+        std::string path_(path);
+        path_ += this->name_;
+
+        std::ifstream infile(path_.c_str(), std::ifstream::binary | std::ifstream::in);
+        cereal::PortableBinaryInputArchive ia(infile);
+        ia(*this);
+    }
+
+    /***************** End of Implementation Section ******************/
+
+}// namespace CoGaDB
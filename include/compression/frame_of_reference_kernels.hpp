@@ -0,0 +1,127 @@
+#pragma once
+
+#include <core/cpu_features.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace CoGaDB {
+
+    /*! \brief number of values packed together by packBlock and unpackBlock*/
+    constexpr size_t FOR_BLOCK_SIZE = 128;
+
+    /*! \brief maps value to an unsigned key with the same order and back
+     *  \details the sign bit of integers is flipped, negative floats are complemented and positive floats get their
+     *  sign bit set. In contrast to the radix sort keys, -0.0 keeps its own key, so decoding is lossless.*/
+    template<class T>
+    inline uint32_t orderedKey(T value) {
+        static_assert(std::is_same_v<T, int> || std::is_same_v<T, float>, "keys are defined for int and float");
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        if constexpr(std::is_same_v<T, float>)
+            return bits ^ (static_cast<uint32_t>(static_cast<int32_t>(bits) >> 31) | 0x80000000u);
+        else
+            return bits ^ 0x80000000u;
+    }
+
+    template<class T>
+    inline T fromOrderedKey(uint32_t key) {
+        static_assert(std::is_same_v<T, int> || std::is_same_v<T, float>, "keys are defined for int and float");
+        uint32_t bits;
+        if constexpr(std::is_same_v<T, float>)
+            bits = key ^ (~static_cast<uint32_t>(static_cast<int32_t>(key) >> 31) | 0x80000000u);
+        else
+            bits = key ^ 0x80000000u;
+        T value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /*
+     * A block of FOR_BLOCK_SIZE values with bit_width bits each occupies 4 * bit_width 32 bit words. Value i belongs
+     * to lane i % 4 and is the (i / 4)-th value of the bit stream of its lane, word k of lane l is stored at position
+     * 4 * k + l. This way, one 128 bit register holds the current word of all four lanes and the block is unpacked
+     * with four values per instruction.
+     */
+
+    /*! \brief packs the low bit_width bits of FOR_BLOCK_SIZE offsets to out, which has to hold 4 * bit_width words*/
+    inline void packBlock(const uint32_t *offsets, unsigned int bit_width, uint32_t *out) {
+        // a block without bits has no words, out may even be null then
+        if (bit_width == 0)
+            return;
+        std::memset(out, 0, 4 * bit_width * sizeof(uint32_t));
+        const uint32_t mask = bit_width == 32 ? ~uint32_t(0) : (uint32_t(1) << bit_width) - 1;
+        for (size_t i = 0; i < FOR_BLOCK_SIZE; i++) {
+            size_t lane = i % 4, bit = (i / 4) * bit_width;
+            size_t word = bit / 32;
+            unsigned int shift = bit % 32;
+            uint32_t offset = offsets[i] & mask;
+            out[4 * word + lane] |= offset << shift;
+            if (shift + bit_width > 32)
+                out[4 * (word + 1) + lane] |= offset >> (32 - shift);
+        }
+    }
+
+    /*! \brief returns reference plus the offset at position index of a packed block*/
+    inline uint32_t extractValue(const uint32_t *in, unsigned int bit_width, uint32_t reference, size_t index) {
+        if (bit_width == 0)
+            return reference;
+        const uint32_t mask = bit_width == 32 ? ~uint32_t(0) : (uint32_t(1) << bit_width) - 1;
+        size_t lane = index % 4, bit = (index / 4) * bit_width;
+        size_t word = bit / 32;
+        unsigned int shift = bit % 32;
+        uint64_t value = in[4 * word + lane] >> shift;
+        if (shift + bit_width > 32)
+            value |= uint64_t(in[4 * (word + 1) + lane]) << (32 - shift);
+        return reference + (static_cast<uint32_t>(value) & mask);
+    }
+
+    namespace detail {
+        inline void unpackBlockScalar(const uint32_t *in, unsigned int bit_width, uint32_t reference, uint32_t *out) {
+            for (size_t i = 0; i < FOR_BLOCK_SIZE; i++)
+                out[i] = extractValue(in, bit_width, reference, i);
+        }
+
+#ifdef COGADB_X86_SIMD
+        /*! \brief unpacks the four lanes at once, every iteration produces the values 4 * j to 4 * j + 3*/
+        inline void unpackBlockSSE2(const uint32_t *in, unsigned int bit_width, uint32_t reference, uint32_t *out) {
+            const __m128i mask = _mm_set1_epi32(bit_width == 32 ? -1 : static_cast<int>((uint32_t(1) << bit_width) - 1));
+            const __m128i base = _mm_set1_epi32(static_cast<int>(reference));
+            const auto *words = reinterpret_cast<const __m128i *>(in);
+            __m128i word = _mm_loadu_si128(words++);
+            unsigned int shift = 0;
+            for (size_t j = 0; j < FOR_BLOCK_SIZE / 4; j++) {
+                __m128i value = _mm_srl_epi32(word, _mm_cvtsi32_si128(static_cast<int>(shift)));
+                shift += bit_width;
+                if (shift >= 32) {
+                    shift -= 32;
+                    // the last word of a lane is consumed exactly by the last value
+                    if (j + 1 < FOR_BLOCK_SIZE / 4)
+                        word = _mm_loadu_si128(words++);
+                    if (shift > 0)
+                        value = _mm_or_si128(value, _mm_sll_epi32(word, _mm_cvtsi32_si128(static_cast<int>(bit_width - shift))));
+                }
+                value = _mm_add_epi32(_mm_and_si128(value, mask), base);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 4 * j), value);
+            }
+        }
+#endif
+    } // namespace detail
+
+    /*! \brief writes reference plus every offset of a packed block to out
+     *  \details blocks are unpacked with SSE2 if available, otherwise with a scalar loop*/
+    inline void unpackBlock(const uint32_t *in, unsigned int bit_width, uint32_t reference, uint32_t *out) {
+        if (bit_width == 0) {
+            for (size_t i = 0; i < FOR_BLOCK_SIZE; i++)
+                out[i] = reference;
+            return;
+        }
+#ifdef COGADB_X86_SIMD
+        detail::unpackBlockSSE2(in, bit_width, reference, out);
+#else
+        detail::unpackBlockScalar(in, bit_width, reference, out);
+#endif
+    }
+
+} // namespace CoGaDB
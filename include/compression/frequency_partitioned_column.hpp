@@ -0,0 +1,530 @@
+#pragma once
+
+#include "bit_packed_vector.hpp"
+#include "compressed_column.hpp"
+#include "core/global_definitions.hpp"
+#include "cereal/types/vector.hpp"
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace CoGaDB {
+
+    /*!
+     *  \brief This class represents a frequency partitioned column with type T.
+     *  \details The distinct values are split into partitions by their frequency: the most frequent values form the
+     *  first partition, which uses the narrowest codes, every following partition holds less frequent values with
+     *  wider codes. Each partition has its own sorted dictionary and stores the fixed-width codes of its rows in row
+     *  order. A bit-packed partition id per row, together with the number of rows of every partition in front of each
+     *  checkpoint, locates the code of a row. Values inserted after the last repartition() are appended to the widest
+     *  partition; bulk insert and load repartition the column. Selections skip partitions whose value range cannot
+     *  match and accept partitions whose value range matches completely without looking at their codes.
+     */
+    template<class T>
+    class FrequencyPartitionedColumn final : public CompressedColumn<T> {
+    public:
+        /*! \brief number of partitions*/
+        static constexpr size_t NUMBER_OF_PARTITIONS = 4;
+
+        /*! \brief code width of every partition, partition p holds at most 2^PARTITION_BITS[p] values*/
+        static constexpr std::array<unsigned int, NUMBER_OF_PARTITIONS> PARTITION_BITS = {4, 8, 16, 32};
+
+        /*! \brief number of rows between two checkpoints*/
+        static constexpr TID CHECKPOINT_INTERVAL = 1024;
+
+        /***************** constructors and destructor *****************/
+        explicit FrequencyPartitionedColumn(const std::string &name);
+
+        ~FrequencyPartitionedColumn() final;
+
+        void insert(const ColumnType &new_Value) final;
+
+        void insert(const T &new_value) final;
+
+        /*! \brief appends the values and repartitions the column*/
+        template<typename InputIterator>
+        void insert(InputIterator first, InputIterator last);
+
+        void update(TID tid, const ColumnType &new_value) final;
+
+        void update(PositionList &tid, const ColumnType &new_value) final;
+
+        void remove(TID tid) final;
+
+        // assumes tid list is sorted ascending
+        void remove(PositionList &tid) final;
+
+        void clearContent() final;
+
+        ColumnType get(TID tid) final;
+
+        std::string print() const noexcept final;
+
+        [[nodiscard]] size_t size() const noexcept final;
+
+        [[nodiscard]] size_t getSizeInBytes() const noexcept final;
+
+        [[nodiscard]] virtual std::unique_ptr<ColumnBase> copy() const;
+
+        void store(const std::string &path) final;
+
+        void load(const std::string &path) final;
+
+        T operator[](int index) final;
+
+        /*! \brief decodes the rows of all partitions in one pass over the partition ids*/
+        void decompress(TID begin, TID end, T *out) const final;
+
+        /*! \brief reassigns the values to the partitions by their current frequencies and drops unused values*/
+        void repartition();
+
+        /**
+         * @brief Serialization method called by Cereal. Implement this method in your compressed columns to get serialization working.
+         */
+        template<class Archive>
+        void serialize(Archive &archive) {
+            archive(partition_ids, partitions);
+        }
+
+    protected:
+        /*! \brief evaluates the predicate once per partition and dictionary entry, the returned scan skips partitions
+         * that cannot match*/
+        typename ColumnBaseTyped<T>::RangeSelection prepareSelection(const T &value, ValueComparator comp) final;
+
+        /*! \brief transforms the dictionaries and repartitions the column*/
+        void applyScalar(ColumnAlgebraOperation op, const T &value) final;
+
+    private:
+        struct Partition {
+            /*! dictionary, the value of code c is stored at dic[c]*/
+            std::vector<T> dic;
+            /*! number of rows referencing each code*/
+            std::vector<unsigned int> code_counts;
+            /*! codes of the rows of this partition in row order*/
+            BitPackedVector codes;
+            /*! bounds of the values of the partition, they may be wider than necessary after updates*/
+            T min{};
+            T max{};
+
+            template<class Archive>
+            void serialize(Archive &archive) {
+                archive(dic, codes);
+            }
+        };
+
+        using PartitionCounts = std::array<TID, NUMBER_OF_PARTITIONS>;
+
+        /*! \brief returns the partition and the code of value, adds value to the widest partition if necessary and
+         * counts the new reference*/
+        std::pair<uint32_t, uint32_t> acquireCode(const T &value);
+
+        /*! \brief returns the number of rows of every partition in front of position tid*/
+        PartitionCounts ranksAt(TID tid) const;
+
+        /*! \brief recomputes all checkpoints behind position from*/
+        void rebuildCheckpoints(TID from);
+
+        /*! \brief rebuilds reference counts, value bounds and the index from the dictionaries and codes*/
+        void rebuildIndex();
+
+        /*! partition of every row*/
+        BitPackedVector partition_ids;
+        std::vector<Partition> partitions;
+        /*! index from value to its partition and code*/
+        std::unordered_map<T, std::pair<uint32_t, uint32_t>> index;
+        /*! checkpoints[i] holds the number of rows of every partition in front of row i * CHECKPOINT_INTERVAL*/
+        std::vector<PartitionCounts> checkpoints;
+    };
+
+    /***************** Start of Implementation Section ******************/
+
+    template<class T>
+    FrequencyPartitionedColumn<T>::FrequencyPartitionedColumn(const std::string &name)
+            : CompressedColumn<T>(name), partition_ids(BitPackedVector::requiredBits(NUMBER_OF_PARTITIONS - 1)),
+              partitions(NUMBER_OF_PARTITIONS), index(), checkpoints(1, PartitionCounts{}) {
+    }
+
+    template<class T>
+    FrequencyPartitionedColumn<T>::~FrequencyPartitionedColumn() = default;
+
+    template<class T>
+    std::pair<uint32_t, uint32_t> FrequencyPartitionedColumn<T>::acquireCode(const T &value) {
+        auto it = index.find(value);
+        if (it != index.end()) {
+            partitions[it->second.first].code_counts[it->second.second]++;
+            return it->second;
+        }
+        auto partition = static_cast<uint32_t>(NUMBER_OF_PARTITIONS - 1);
+        Partition &widest = partitions[partition];
+        auto code = static_cast<uint32_t>(widest.dic.size());
+        if (widest.dic.empty()) {
+            widest.min = value;
+            widest.max = value;
+        } else {
+            widest.min = std::min(widest.min, value);
+            widest.max = std::max(widest.max, value);
+        }
+        widest.dic.push_back(value);
+        widest.code_counts.push_back(1);
+        return index.emplace(value, std::make_pair(partition, code)).first->second;
+    }
+
+    template<class T>
+    typename FrequencyPartitionedColumn<T>::PartitionCounts FrequencyPartitionedColumn<T>::ranksAt(TID tid) const {
+        TID checkpoint = tid / CHECKPOINT_INTERVAL;
+        PartitionCounts ranks = checkpoints[checkpoint];
+        uint32_t chunk[CHECKPOINT_INTERVAL];
+        TID begin = checkpoint * CHECKPOINT_INTERVAL;
+        partition_ids.unpack(begin, tid, chunk);
+        for (TID i = 0; i < tid - begin; i++)
+            ranks[chunk[i]]++;
+        return ranks;
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::rebuildCheckpoints(TID from) {
+        TID checkpoint = from / CHECKPOINT_INTERVAL;
+        checkpoints.resize(partition_ids.size() / CHECKPOINT_INTERVAL + 1);
+        PartitionCounts counts = checkpoints[checkpoint];
+        for (TID i = checkpoint * CHECKPOINT_INTERVAL; i < partition_ids.size(); i++) {
+            if (i % CHECKPOINT_INTERVAL == 0)
+                checkpoints[i / CHECKPOINT_INTERVAL] = counts;
+            counts[partition_ids[i]]++;
+        }
+        if (partition_ids.size() % CHECKPOINT_INTERVAL == 0)
+            checkpoints.back() = counts;
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::rebuildIndex() {
+        index.clear();
+        for (uint32_t p = 0; p < NUMBER_OF_PARTITIONS; p++) {
+            Partition &partition = partitions[p];
+            partition.code_counts.assign(partition.dic.size(), 0);
+            for (size_t i = 0; i < partition.codes.size(); i++)
+                partition.code_counts[partition.codes[i]]++;
+            for (uint32_t code = 0; code < partition.dic.size(); code++) {
+                const T &value = partition.dic[code];
+                if (code == 0 || value < partition.min)
+                    partition.min = value;
+                if (code == 0 || partition.max < value)
+                    partition.max = value;
+                index.emplace(value, std::make_pair(p, code));
+            }
+        }
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::repartition() {
+        std::vector<T> values = this->materializeValues();
+
+        // count the values and order them by descending frequency
+        std::unordered_map<T, size_t> frequencies;
+        for (const T &value: values)
+            frequencies[value]++;
+        std::vector<std::pair<T, size_t>> by_frequency(frequencies.begin(), frequencies.end());
+        std::sort(by_frequency.begin(), by_frequency.end(), [](const std::pair<T, size_t> &a, const std::pair<T, size_t> &b) {
+            return a.second > b.second || (a.second == b.second && a.first < b.first);
+        });
+
+        // fill the partitions from the narrowest to the widest, every dictionary is sorted by value
+        std::vector<Partition> new_partitions(NUMBER_OF_PARTITIONS);
+        size_t first = 0;
+        for (size_t p = 0; p < NUMBER_OF_PARTITIONS; p++) {
+            size_t capacity = PARTITION_BITS[p] >= 32 ? by_frequency.size() : size_t(1) << PARTITION_BITS[p];
+            size_t last = p + 1 == NUMBER_OF_PARTITIONS ? by_frequency.size() : std::min(by_frequency.size(), first + capacity);
+            Partition &partition = new_partitions[p];
+            size_t rows = 0;
+            for (size_t i = first; i < last; i++) {
+                rows += by_frequency[i].second;
+                partition.dic.push_back(std::move(by_frequency[i].first));
+            }
+            std::sort(partition.dic.begin(), partition.dic.end());
+            partition.codes = BitPackedVector(BitPackedVector::requiredBits(partition.dic.empty() ? 0 : partition.dic.size() - 1));
+            partition.codes.reserve(rows);
+            first = last;
+        }
+        partitions = std::move(new_partitions);
+        index.clear();
+        for (uint32_t p = 0; p < NUMBER_OF_PARTITIONS; p++) {
+            for (uint32_t code = 0; code < partitions[p].dic.size(); code++)
+                index.emplace(partitions[p].dic[code], std::make_pair(p, code));
+        }
+
+        // re-encode the rows
+        partition_ids.clear();
+        partition_ids.reserve(values.size());
+        for (const T &value: values) {
+            const auto &location = index.find(value)->second;
+            partition_ids.push_back(location.first);
+            partitions[location.first].codes.push_back(location.second);
+        }
+        rebuildIndex();
+        rebuildCheckpoints(0);
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::insert(const ColumnType &new_Value) {
+        this->insert(std::get<T>(new_Value));
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::insert(const T &new_value) {
+        auto location = acquireCode(new_value);
+        partition_ids.push_back(location.first);
+        partitions[location.first].codes.push_back(location.second);
+        if (partition_ids.size() % CHECKPOINT_INTERVAL == 0) {
+            PartitionCounts counts{};
+            for (size_t p = 0; p < NUMBER_OF_PARTITIONS; p++)
+                counts[p] = static_cast<TID>(partitions[p].codes.size());
+            checkpoints.push_back(counts);
+        }
+    }
+
+    template<typename T>
+    template<typename InputIterator>
+    void FrequencyPartitionedColumn<T>::insert(InputIterator first, InputIterator last) {
+        if constexpr(std::is_base_of_v<std::forward_iterator_tag,
+                                       typename std::iterator_traits<InputIterator>::iterator_category>) {
+            partition_ids.reserve(partition_ids.size() + std::distance(first, last));
+        }
+        for (InputIterator i = first; i != last; ++i)
+            this->insert(*i);
+        repartition();
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::update(TID tid, const ColumnType &new_value) {
+        if (tid >= partition_ids.size())
+            throw std::out_of_range("FrequencyPartitionedColumn::update(): invalid tid " + std::to_string(tid));
+
+        // acquire the new code first, so an equal value is not released
+        auto location = acquireCode(std::get<T>(new_value));
+        uint32_t old_partition = partition_ids[tid];
+        TID old_rank = ranksAt(tid)[old_partition];
+        partitions[old_partition].code_counts[partitions[old_partition].codes[old_rank]]--;
+
+        if (old_partition == location.first) {
+            partitions[old_partition].codes.set(old_rank, location.second);
+            return;
+        }
+        // the row moves to another partition, the rows in front of it do not change
+        TID new_rank = ranksAt(tid)[location.first];
+        partitions[old_partition].codes.erase(old_rank);
+        partitions[location.first].codes.insert(new_rank, location.second);
+        partition_ids.set(tid, location.first);
+        for (size_t checkpoint = tid / CHECKPOINT_INTERVAL + 1; checkpoint < checkpoints.size(); checkpoint++) {
+            checkpoints[checkpoint][old_partition]--;
+            checkpoints[checkpoint][location.first]++;
+        }
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::update(PositionList &tids, const ColumnType &new_value) {
+        for (TID tid: tids)
+            update(tid, new_value);
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::remove(TID tid) {
+        if (tid >= partition_ids.size())
+            throw std::out_of_range("FrequencyPartitionedColumn::remove(): invalid tid " + std::to_string(tid));
+
+        uint32_t partition = partition_ids[tid];
+        TID rank = ranksAt(tid)[partition];
+        partitions[partition].code_counts[partitions[partition].codes[rank]]--;
+        partitions[partition].codes.erase(rank);
+        partition_ids.erase(tid);
+        rebuildCheckpoints(tid);
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::remove(PositionList &tids) {
+        // remove from the back, so the remaining tids stay valid
+        for (auto rit = tids.rbegin(); rit != tids.rend(); ++rit)
+            remove(*rit);
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::clearContent() {
+        partition_ids.clear();
+        partitions.assign(NUMBER_OF_PARTITIONS, Partition());
+        index.clear();
+        checkpoints.assign(1, PartitionCounts{});
+    }
+
+    template<class T>
+    ColumnType FrequencyPartitionedColumn<T>::get(TID tid) {
+        if (tid >= partition_ids.size())
+            throw std::out_of_range("FrequencyPartitionedColumn::get(): invalid tid " + std::to_string(tid));
+        return (*this)[tid];
+    }
+
+    template<class T>
+    T FrequencyPartitionedColumn<T>::operator[](const int index_) {
+        auto tid = static_cast<TID>(index_);
+        uint32_t partition = partition_ids[tid];
+        const Partition &part = partitions[partition];
+        return part.dic[part.codes[ranksAt(tid)[partition]]];
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::decompress(TID begin, TID end, T *out) const {
+        if (begin >= end)
+            return;
+        PartitionCounts ranks = ranksAt(begin);
+        uint32_t chunk[CHECKPOINT_INTERVAL];
+        for (TID chunk_begin = begin; chunk_begin < end; chunk_begin += CHECKPOINT_INTERVAL) {
+            TID chunk_end = std::min(chunk_begin + CHECKPOINT_INTERVAL, end);
+            partition_ids.unpack(chunk_begin, chunk_end, chunk);
+            for (TID i = 0; i < chunk_end - chunk_begin; i++) {
+                const Partition &partition = partitions[chunk[i]];
+                *out++ = partition.dic[partition.codes[ranks[chunk[i]]++]];
+            }
+        }
+    }
+
+    template<class T>
+    typename ColumnBaseTyped<T>::RangeSelection FrequencyPartitionedColumn<T>::prepareSelection(const T &value, const ValueComparator comp) {
+        enum Match : char { NONE, ALL, SOME };
+        auto matches = std::make_shared<std::array<Match, NUMBER_OF_PARTITIONS>>();
+        auto qualifies = std::make_shared<std::array<std::vector<char>, NUMBER_OF_PARTITIONS>>();
+
+        // decide per partition from its value bounds, evaluate the predicate per dictionary entry only if necessary
+        auto found = comp == EQUAL ? index.find(value) : index.end();
+        bool all = true, none = true;
+        for (size_t p = 0; p < NUMBER_OF_PARTITIONS; p++) {
+            const Partition &partition = partitions[p];
+            Match &match = (*matches)[p];
+            if (partition.codes.empty()) {
+                match = NONE;
+                continue;
+            }
+            if (comp == EQUAL) {
+                match = found != index.end() && found->second.first == p ? SOME : NONE;
+            } else if (comp == LESSER) {
+                match = partition.max < value ? ALL : (partition.min < value ? SOME : NONE);
+            } else {
+                match = value < partition.min ? ALL : (value < partition.max ? SOME : NONE);
+            }
+            if (match == SOME) {
+                std::vector<char> &table = (*qualifies)[p];
+                table.resize(partition.dic.size());
+                for (size_t code = 0; code < partition.dic.size(); code++) {
+                    const T &entry = partition.dic[code];
+                    table[code] = comp == EQUAL ? entry == value : (comp == LESSER ? entry < value : value < entry);
+                }
+            }
+            all &= match == ALL;
+            none &= match == NONE;
+        }
+
+        if (none)
+            return [](TID, TID, PositionList &) {};
+        if (all) {
+            return [](TID begin, TID end, PositionList &result_tids) {
+                size_t offset = result_tids.size();
+                result_tids.resize(offset + (end - begin));
+                std::iota(result_tids.begin() + offset, result_tids.end(), begin);
+            };
+        }
+        return [this, matches, qualifies](TID begin, TID end, PositionList &result_tids) {
+            if (begin >= end)
+                return;
+            PartitionCounts ranks = ranksAt(begin);
+            uint32_t chunk[CHECKPOINT_INTERVAL];
+            for (TID chunk_begin = begin; chunk_begin < end; chunk_begin += CHECKPOINT_INTERVAL) {
+                TID chunk_end = std::min(chunk_begin + CHECKPOINT_INTERVAL, end);
+                partition_ids.unpack(chunk_begin, chunk_end, chunk);
+                for (TID i = 0; i < chunk_end - chunk_begin; i++) {
+                    uint32_t p = chunk[i];
+                    Match match = (*matches)[p];
+                    if (match == ALL || (match == SOME && (*qualifies)[p][partitions[p].codes[ranks[p]]]))
+                        result_tids.push_back(chunk_begin + i);
+                    ranks[p]++;
+                }
+            }
+        };
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::applyScalar(ColumnAlgebraOperation op, const T &value) {
+        // entries may collide after the transformation, repartitioning merges them
+        for (Partition &partition: partitions) {
+            for (T &entry: partition.dic)
+                entry = applyOperation(op, entry, value);
+        }
+        repartition();
+    }
+
+    template<class T>
+    std::string FrequencyPartitionedColumn<T>::print() const noexcept {
+        std::string str = "| " + this->name_ + " |\n________________________\n";
+        std::vector<T> values(partition_ids.size());
+        decompress(0, static_cast<TID>(values.size()), values.data());
+        for (const T &value: values) {
+            if constexpr(std::is_same_v<std::string, T>)
+                str.append("| " + value + " |\n");
+            else
+                str.append("| " + std::to_string(value) + " |\n");
+        }
+        return str;
+    }
+
+    template<class T>
+    size_t FrequencyPartitionedColumn<T>::size() const noexcept {
+        return partition_ids.size();
+    }
+
+    template<class T>
+    size_t FrequencyPartitionedColumn<T>::getSizeInBytes() const noexcept {
+        size_t bytes = partition_ids.getSizeInBytes() + checkpoints.size() * sizeof(PartitionCounts);
+        for (const Partition &partition: partitions) {
+            bytes += partition.codes.getSizeInBytes() + partition.dic.size() * (sizeof(T) + sizeof(unsigned int));
+            for (const T &value: partition.dic)
+                bytes += detail::heapBytes(value);
+        }
+        // the value index holds a copy of every dictionary value
+        bytes += index.size() * detail::index_entry_bytes<T>;
+        for (const auto &entry: index)
+            bytes += detail::heapBytes(entry.first);
+        return bytes;
+    }
+
+    template<class T>
+    std::unique_ptr<ColumnBase> FrequencyPartitionedColumn<T>::copy() const {
+        return std::make_unique<FrequencyPartitionedColumn<T>>(*this);
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::store(const std::string &path) {
+        std::string path_(path);
+        path_ += this->name_;
+
+        std::ofstream outfile(path_.c_str(), std::ofstream::binary | std::ofstream::out | std::ofstream::trunc);
+        assert(outfile.is_open());
+        cereal::PortableBinaryOutputArchive oarchive(outfile);
+        oarchive(*this);
+    }
+
+    template<class T>
+    void FrequencyPartitionedColumn<T>::load(const std::string &path) {
+        std::string path_(path);
+        path_ += this->name_;
+
+        std::ifstream infile(path_.c_str(), std::ifstream::binary | std::ifstream::in);
+        cereal::PortableBinaryInputArchive ia(infile);
+        ia(*this);
+
+        rebuildIndex();
+        rebuildCheckpoints(0);
+        repartition();
+    }
+
+    /***************** End of Implementation Section ******************/
+
+}// namespace CoGaDB
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace CoGaDB {
+
+    /*!
+     *  \brief This class stores a sorted set of strings front coded in a single buffer.
+     *  \details The strings are grouped into blocks of BLOCK_SIZE strings. The first string of a block is stored
+     *  completely, every following string as the length of the prefix it shares with its predecessor plus the
+     *  remaining suffix. Lengths are variable-length integers. Lookups binary search the first strings of the blocks
+     *  and decode at most one block. The code of a string is its position in the sorted order.
+     */
+    class FrontCodedDictionary {
+    public:
+        /*! \brief number of strings per block*/
+        static constexpr size_t BLOCK_SIZE = 16;
+
+        /***************** constructors and destructor *****************/
+        FrontCodedDictionary() = default;
+
+        /*! \brief encodes values, which have to be sorted ascending without duplicates*/
+        explicit FrontCodedDictionary(const std::vector<std::string> &values);
+
+        /*! \brief returns the string with code code*/
+        [[nodiscard]] std::string operator[](uint32_t code) const;
+
+        /*! \brief replaces the content of out by all strings of the block with index block*/
+        void decodeBlock(size_t block, std::vector<std::string> &out) const;
+
+        /*! \brief returns the code of the first string not less than value, size() if there is none*/
+        [[nodiscard]] uint32_t lowerBound(std::string_view value) const;
+
+        /*! \brief returns the code of the first string greater than value, size() if there is none*/
+        [[nodiscard]] uint32_t upperBound(std::string_view value) const;
+
+        /*! \brief returns the code of value or -1 if the dictionary does not contain it*/
+        [[nodiscard]] int64_t find(std::string_view value) const;
+
+        [[nodiscard]] size_t size() const noexcept { return count; }
+
+        [[nodiscard]] bool empty() const noexcept { return count == 0; }
+
+        /*! \brief returns the size in bytes the dictionary consumes in main memory*/
+        [[nodiscard]] size_t getSizeInBytes() const noexcept {
+            return buffer.capacity() + block_offsets.capacity() * sizeof(uint32_t);
+        }
+
+        template<class Archive>
+        void serialize(Archive &archive) {
+            archive(count, buffer, block_offsets);
+        }
+
+    private:
+        static void putLength(std::vector<char> &out, size_t length);
+
+        static size_t getLength(const char *&in);
+
+        /*! \brief returns the first string of the block with index block*/
+        [[nodiscard]] std::string_view head(size_t block) const;
+
+        /*! \brief returns the index of the last block whose first string is not greater than value (less_equal) or
+         * less than value (!less_equal), or -1 if there is none*/
+        [[nodiscard]] int64_t findBlock(std::string_view value, bool less_equal) const;
+
+        /*! \brief returns the first code of the block with index block whose string satisfies predicate*/
+        template<class Predicate>
+        [[nodiscard]] uint32_t scanBlock(int64_t block, Predicate predicate) const;
+
+        uint32_t count = 0;
+        std::vector<char> buffer;
+        /*! position of every block in buffer*/
+        std::vector<uint32_t> block_offsets;
+    };
+
+    /***************** Start of Implementation Section ******************/
+
+    inline FrontCodedDictionary::FrontCodedDictionary(const std::vector<std::string> &values)
+            : count(static_cast<uint32_t>(values.size())) {
+        block_offsets.reserve((values.size() + BLOCK_SIZE - 1) / BLOCK_SIZE);
+        for (size_t i = 0; i < values.size(); i++) {
+            const std::string &value = values[i];
+            if (i % BLOCK_SIZE == 0) {
+                block_offsets.push_back(static_cast<uint32_t>(buffer.size()));
+                putLength(buffer, value.size());
+                buffer.insert(buffer.end(), value.begin(), value.end());
+                continue;
+            }
+            const std::string &previous = values[i - 1];
+            size_t shared = std::mismatch(value.begin(), value.begin() + std::min(value.size(), previous.size()),
+                                          previous.begin()).first - value.begin();
+            putLength(buffer, shared);
+            putLength(buffer, value.size() - shared);
+            buffer.insert(buffer.end(), value.begin() + shared, value.end());
+        }
+        buffer.shrink_to_fit();
+    }
+
+    inline void FrontCodedDictionary::putLength(std::vector<char> &out, size_t length) {
+        // 7 bits per byte, the highest bit marks that another byte follows
+        while (length >= 0x80) {
+            out.push_back(static_cast<char>((length & 0x7F) | 0x80));
+            length >>= 7;
+        }
+        out.push_back(static_cast<char>(length));
+    }
+
+    inline size_t FrontCodedDictionary::getLength(const char *&in) {
+        size_t length = 0;
+        for (unsigned int shift = 0;; shift += 7) {
+            auto byte = static_cast<unsigned char>(*in++);
+            length |= size_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return length;
+        }
+    }
+
+    inline std::string_view FrontCodedDictionary::head(size_t block) const {
+        const char *in = buffer.data() + block_offsets[block];
+        size_t length = getLength(in);
+        return {in, length};
+    }
+
+    inline void FrontCodedDictionary::decodeBlock(size_t block, std::vector<std::string> &out) const {
+        out.clear();
+        const char *in = buffer.data() + block_offsets[block];
+        size_t length = getLength(in);
+        out.emplace_back(in, length);
+        in += length;
+        size_t end = std::min<size_t>(count, (block + 1) * BLOCK_SIZE);
+        for (size_t code = block * BLOCK_SIZE + 1; code < end; code++) {
+            size_t shared = getLength(in);
+            size_t suffix = getLength(in);
+            std::string value(out.back(), 0, shared);
+            value.append(in, suffix);
+            in += suffix;
+            out.push_back(std::move(value));
+        }
+    }
+
+    inline std::string FrontCodedDictionary::operator[](uint32_t code) const {
+        const char *in = buffer.data() + block_offsets[code / BLOCK_SIZE];
+        size_t length = getLength(in);
+        std::string value(in, length);
+        in += length;
+        for (size_t i = 0; i < code % BLOCK_SIZE; i++) {
+            size_t shared = getLength(in);
+            size_t suffix = getLength(in);
+            value.resize(shared);
+            value.append(in, suffix);
+            in += suffix;
+        }
+        return value;
+    }
+
+    inline int64_t FrontCodedDictionary::findBlock(std::string_view value, bool less_equal) const {
+        // binary search for the first block whose first string does not qualify, the block in front of it is the result
+        size_t low = 0, high = block_offsets.size();
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            std::string_view block_head = head(middle);
+            if (less_equal ? block_head <= value : block_head < value)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+        return static_cast<int64_t>(low) - 1;
+    }
+
+    template<class Predicate>
+    uint32_t FrontCodedDictionary::scanBlock(int64_t block, Predicate predicate) const {
+        if (block < 0)
+            return 0;
+        const char *in = buffer.data() + block_offsets[block];
+        size_t length = getLength(in);
+        std::string value(in, length);
+        in += length;
+        size_t end = std::min<size_t>(count, (block + 1) * BLOCK_SIZE);
+        for (size_t code = block * BLOCK_SIZE;;) {
+            if (predicate(value))
+                return static_cast<uint32_t>(code);
+            if (++code == end)
+                return static_cast<uint32_t>(end);
+            size_t shared = getLength(in);
+            size_t suffix = getLength(in);
+            value.resize(shared);
+            value.append(in, suffix);
+            in += suffix;
+        }
+    }
+
+    inline uint32_t FrontCodedDictionary::lowerBound(std::string_view value) const {
+        return scanBlock(findBlock(value, false), [value](const std::string &entry) { return entry >= value; });
+    }
+
+    inline uint32_t FrontCodedDictionary::upperBound(std::string_view value) const {
+        return scanBlock(findBlock(value, true), [value](const std::string &entry) { return entry > value; });
+    }
+
+    inline int64_t FrontCodedDictionary::find(std::string_view value) const {
+        uint32_t code = lowerBound(value);
+        if (code < count && (*this)[code] == value)
+            return code;
+        return -1;
+    }
+
+    /***************** End of Implementation Section ******************/
+
+} // namespace CoGaDB
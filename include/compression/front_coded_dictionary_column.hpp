@@ -0,0 +1,448 @@
+#pragma once
+
+#include "bit_packed_vector.hpp"
+#include "compressed_column.hpp"
+#include "front_coded_dictionary.hpp"
+#include "core/global_definitions.hpp"
+#include "cereal/types/string.hpp"
+#include "cereal/types/vector.hpp"
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace CoGaDB {
+
+    /*!
+     *  \brief This class represents a dictionary compressed string column with a front coded dictionary.
+     *  \details The sorted dictionary is stored front coded in a single buffer (see FrontCodedDictionary), so a value
+     *  costs its suffix and a few bytes instead of a std::string with its own allocation. The code of a value is its
+     *  position in the sorted dictionary, the codes of the rows are bit-packed. Values that are not part of the sorted
+     *  dictionary yet are kept in a small unsorted pending dictionary with the codes behind the sorted ones. compact()
+     *  merges the pending values into the sorted dictionary and drops unused values; it runs after bulk inserts and
+     *  loads, when the pending dictionary outgrows the sorted one, and before range predicates and sorting. Then EQUAL,
+     *  LESSER and GREATER are translated into a code or a code range by binary search and evaluated on the codes only.
+     */
+    class FrontCodedDictionaryColumn final : public CompressedColumn<std::string> {
+    public:
+        /*! \brief number of pending values that are always tolerated without compaction*/
+        static constexpr size_t PENDING_LIMIT = 1024;
+
+        /***************** constructors and destructor *****************/
+        explicit FrontCodedDictionaryColumn(const std::string &name);
+
+        ~FrontCodedDictionaryColumn() final;
+
+        void insert(const ColumnType &new_Value) final;
+
+        void insert(const std::string &new_value) final;
+
+        /*! \brief appends the values and compacts the dictionary*/
+        template<typename InputIterator>
+        void insert(InputIterator first, InputIterator last);
+
+        void update(TID tid, const ColumnType &new_value) final;
+
+        void update(PositionList &tid, const ColumnType &new_value) final;
+
+        void remove(TID tid) final;
+
+        // assumes tid list is sorted ascending
+        void remove(PositionList &tid) final;
+
+        void clearContent() final;
+
+        ColumnType get(TID tid) final;
+
+        std::string print() const noexcept final;
+
+        [[nodiscard]] size_t size() const noexcept final;
+
+        [[nodiscard]] size_t getSizeInBytes() const noexcept final;
+
+        [[nodiscard]] virtual std::unique_ptr<ColumnBase> copy() const;
+
+        void store(const std::string &path) final;
+
+        void load(const std::string &path) final;
+
+        std::string operator[](int index) final;
+
+        /*! \brief decodes the whole dictionary once for large ranges, single codes for small ones*/
+        void decompress(TID begin, TID end, std::string *out) const final;
+
+        /*! \brief counting sorts the rows by their codes, which are ranks after compaction*/
+        PositionList sort(SortOrder order) final;
+
+        /*! \brief merges the pending values into the sorted dictionary, drops unused values and re-encodes the rows*/
+        void compact();
+
+        /**
+         * @brief Serialization method called by Cereal. Implement this method in your compressed columns to get serialization working.
+         */
+        template<class Archive>
+        void serialize(Archive &archive) {
+            archive(dictionary, pending, values);
+        }
+
+    protected:
+        /*! \brief translates the predicate into a code or a code range, the returned scan works on the codes only*/
+        RangeSelection prepareSelection(const std::string &value, ValueComparator comp) final;
+
+    private:
+        /*! \brief returns the code of value or -1 if it is not part of any dictionary*/
+        [[nodiscard]] int64_t lookup(const std::string &value) const;
+
+        /*! \brief returns the code of value, adds value to the pending dictionary if necessary and counts the new
+         * reference*/
+        uint32_t acquireCode(const std::string &value);
+
+        /*! \brief returns the value of code*/
+        [[nodiscard]] std::string decode(uint32_t code) const;
+
+        /*! \brief compacts the dictionary if the pending dictionary outgrew the sorted one*/
+        void compactIfNecessary();
+
+        /*! \brief rebuilds the reference counts and the index of the pending dictionary*/
+        void rebuildIndex();
+
+        /*! \brief returns a scan emitting the tids of all rows whose code satisfies the predicate*/
+        template<class CodePredicate>
+        RangeSelection scanCodes(CodePredicate predicate) const;
+
+        /*! sorted front coded dictionary, the value of code c < dictionary.size() is dictionary[c]*/
+        FrontCodedDictionary dictionary;
+        /*! values added since the last compaction, the value of code c >= dictionary.size() is
+         * pending[c - dictionary.size()]*/
+        std::vector<std::string> pending;
+        /*! hash index from pending value to code*/
+        std::unordered_map<std::string, uint32_t> pending_codes;
+        /*! number of rows referencing each code*/
+        std::vector<unsigned int> code_counts;
+        /*! bit-packed codes of the rows*/
+        BitPackedVector values;
+    };
+
+    /***************** Start of Implementation Section ******************/
+
+    inline FrontCodedDictionaryColumn::FrontCodedDictionaryColumn(const std::string &name)
+            : CompressedColumn<std::string>(name), dictionary(), pending(), pending_codes(), code_counts(), values() {
+    }
+
+    inline FrontCodedDictionaryColumn::~FrontCodedDictionaryColumn() = default;
+
+    inline int64_t FrontCodedDictionaryColumn::lookup(const std::string &value) const {
+        int64_t code = dictionary.find(value);
+        if (code >= 0)
+            return code;
+        auto it = pending_codes.find(value);
+        return it == pending_codes.end() ? -1 : static_cast<int64_t>(it->second);
+    }
+
+    inline uint32_t FrontCodedDictionaryColumn::acquireCode(const std::string &value) {
+        int64_t code = lookup(value);
+        if (code < 0) {
+            code = static_cast<int64_t>(dictionary.size() + pending.size());
+            pending.push_back(value);
+            pending_codes.emplace(value, static_cast<uint32_t>(code));
+            code_counts.push_back(0);
+        }
+        code_counts[code]++;
+        return static_cast<uint32_t>(code);
+    }
+
+    inline std::string FrontCodedDictionaryColumn::decode(uint32_t code) const {
+        if (code < dictionary.size())
+            return dictionary[code];
+        return pending[code - dictionary.size()];
+    }
+
+    inline void FrontCodedDictionaryColumn::compactIfNecessary() {
+        if (pending.size() > std::max(PENDING_LIMIT, dictionary.size()))
+            compact();
+    }
+
+    inline void FrontCodedDictionaryColumn::rebuildIndex() {
+        code_counts.assign(dictionary.size() + pending.size(), 0);
+        for (size_t i = 0; i < values.size(); i++)
+            code_counts[values[i]]++;
+        pending_codes.clear();
+        for (size_t i = 0; i < pending.size(); i++)
+            pending_codes.emplace(pending[i], static_cast<uint32_t>(dictionary.size() + i));
+    }
+
+    inline void FrontCodedDictionaryColumn::compact() {
+        // the used pending values in sorted order, they never occur in the sorted dictionary
+        std::vector<uint32_t> pending_order;
+        for (uint32_t i = 0; i < pending.size(); i++) {
+            if (code_counts[dictionary.size() + i] > 0)
+                pending_order.push_back(i);
+        }
+        std::sort(pending_order.begin(), pending_order.end(),
+                  [this](uint32_t a, uint32_t b) { return pending[a] < pending[b]; });
+
+        // merge both dictionaries block by block
+        std::vector<std::string> merged;
+        std::vector<uint32_t> new_code(code_counts.size());
+        std::vector<std::string> block_values;
+        auto next_pending = pending_order.begin();
+        auto add = [&](uint32_t code, std::string value) {
+            new_code[code] = static_cast<uint32_t>(merged.size());
+            merged.push_back(std::move(value));
+        };
+        for (size_t block = 0; block * FrontCodedDictionary::BLOCK_SIZE < dictionary.size(); block++) {
+            dictionary.decodeBlock(block, block_values);
+            for (size_t i = 0; i < block_values.size(); i++) {
+                auto code = static_cast<uint32_t>(block * FrontCodedDictionary::BLOCK_SIZE + i);
+                if (code_counts[code] == 0)
+                    continue;
+                for (; next_pending != pending_order.end() && pending[*next_pending] < block_values[i]; ++next_pending)
+                    add(static_cast<uint32_t>(dictionary.size() + *next_pending), std::move(pending[*next_pending]));
+                add(code, std::move(block_values[i]));
+            }
+        }
+        for (; next_pending != pending_order.end(); ++next_pending)
+            add(static_cast<uint32_t>(dictionary.size() + *next_pending), std::move(pending[*next_pending]));
+
+        // re-encode the rows with the new codes
+        BitPackedVector recoded(BitPackedVector::requiredBits(merged.empty() ? 0 : static_cast<uint32_t>(merged.size() - 1)));
+        recoded.reserve(values.size());
+        std::vector<unsigned int> new_counts(merged.size(), 0);
+        constexpr TID CHUNK_SIZE = 1024;
+        uint32_t chunk[CHUNK_SIZE];
+        for (TID chunk_begin = 0; chunk_begin < values.size(); chunk_begin += CHUNK_SIZE) {
+            TID chunk_end = std::min<TID>(chunk_begin + CHUNK_SIZE, values.size());
+            values.unpack(chunk_begin, chunk_end, chunk);
+            for (TID i = 0; i < chunk_end - chunk_begin; i++) {
+                uint32_t code = new_code[chunk[i]];
+                recoded.push_back(code);
+                new_counts[code]++;
+            }
+        }
+
+        dictionary = FrontCodedDictionary(merged);
+        pending.clear();
+        pending_codes.clear();
+        code_counts = std::move(new_counts);
+        values = std::move(recoded);
+    }
+
+    template<class CodePredicate>
+    FrontCodedDictionaryColumn::RangeSelection FrontCodedDictionaryColumn::scanCodes(CodePredicate predicate) const {
+        return [this, predicate](TID begin, TID end, PositionList &result_tids) {
+            constexpr TID CHUNK_SIZE = 1024;
+            uint32_t chunk[CHUNK_SIZE];
+            for (TID chunk_begin = begin; chunk_begin < end; chunk_begin += CHUNK_SIZE) {
+                TID chunk_end = std::min(chunk_begin + CHUNK_SIZE, end);
+                values.unpack(chunk_begin, chunk_end, chunk);
+                for (TID i = 0; i < chunk_end - chunk_begin; i++) {
+                    if (predicate(chunk[i]))
+                        result_tids.push_back(chunk_begin + i);
+                }
+            }
+        };
+    }
+
+    inline FrontCodedDictionaryColumn::RangeSelection
+    FrontCodedDictionaryColumn::prepareSelection(const std::string &value, const ValueComparator comp) {
+        if (comp == EQUAL) {
+            int64_t code = lookup(value);
+            if (code < 0)
+                return [](TID, TID, PositionList &) {};
+            return scanCodes([code = static_cast<uint32_t>(code)](uint32_t c) { return c == code; });
+        }
+
+        // after compaction all codes are ranks, so the predicate becomes a code range
+        if (!pending.empty())
+            compact();
+        if (comp == LESSER) {
+            uint32_t bound = dictionary.lowerBound(value);
+            return scanCodes([bound](uint32_t c) { return c < bound; });
+        }
+        uint32_t bound = dictionary.upperBound(value);
+        return scanCodes([bound](uint32_t c) { return c >= bound; });
+    }
+
+    inline PositionList FrontCodedDictionaryColumn::sort(SortOrder order) {
+        if (!pending.empty())
+            compact();
+
+        // counting sort, the number of rows per code are the reference counts
+        std::vector<size_t> offsets(code_counts.size() + 1, 0);
+        for (size_t code = 0; code < code_counts.size(); code++)
+            offsets[code + 1] = offsets[code] + code_counts[code];
+
+        constexpr TID CHUNK_SIZE = 1024;
+        uint32_t chunk[CHUNK_SIZE];
+        PositionList ids(values.size());
+        for (TID chunk_begin = 0; chunk_begin < values.size(); chunk_begin += CHUNK_SIZE) {
+            TID chunk_end = std::min<TID>(chunk_begin + CHUNK_SIZE, values.size());
+            values.unpack(chunk_begin, chunk_end, chunk);
+            for (TID i = 0; i < chunk_end - chunk_begin; i++)
+                ids[offsets[chunk[i]]++] = chunk_begin + i;
+        }
+
+        // descending is the exact reverse of the ascending (value, tid) order
+        if (order == DESCENDING)
+            std::reverse(ids.begin(), ids.end());
+        return ids;
+    }
+
+    inline void FrontCodedDictionaryColumn::insert(const ColumnType &new_Value) {
+        this->insert(std::get<std::string>(new_Value));
+    }
+
+    inline void FrontCodedDictionaryColumn::insert(const std::string &new_value) {
+        values.push_back(acquireCode(new_value));
+        compactIfNecessary();
+    }
+
+    template<typename InputIterator>
+    void FrontCodedDictionaryColumn::insert(InputIterator first, InputIterator last) {
+        if constexpr(std::is_base_of_v<std::forward_iterator_tag,
+                                       typename std::iterator_traits<InputIterator>::iterator_category>) {
+            values.reserve(values.size() + std::distance(first, last));
+        }
+        // repetitions of the previous value are encoded without a lookup, the value is copied because a single pass
+        // iterator does not keep it alive
+        int64_t previous_code = -1;
+        std::string previous;
+        for (InputIterator i = first; i != last; ++i) {
+            const std::string &value = *i;
+            if (previous_code >= 0 && previous == value) {
+                code_counts[previous_code]++;
+                values.push_back(static_cast<uint32_t>(previous_code));
+                continue;
+            }
+            previous_code = acquireCode(value);
+            values.push_back(static_cast<uint32_t>(previous_code));
+            previous = value;
+        }
+        compact();
+    }
+
+    inline void FrontCodedDictionaryColumn::update(TID tid, const ColumnType &new_value) {
+        if (tid >= values.size())
+            throw std::out_of_range("FrontCodedDictionaryColumn::update(): invalid tid " + std::to_string(tid));
+
+        uint32_t code = acquireCode(std::get<std::string>(new_value));
+        code_counts[values[tid]]--;
+        values.set(tid, code);
+        compactIfNecessary();
+    }
+
+    inline void FrontCodedDictionaryColumn::update(PositionList &tids, const ColumnType &new_value) {
+        for (TID tid: tids)
+            update(tid, new_value);
+    }
+
+    inline void FrontCodedDictionaryColumn::remove(TID tid) {
+        if (tid >= values.size())
+            throw std::out_of_range("FrontCodedDictionaryColumn::remove(): invalid tid " + std::to_string(tid));
+
+        code_counts[values[tid]]--;
+        values.erase(tid);
+    }
+
+    inline void FrontCodedDictionaryColumn::remove(PositionList &tids) {
+        // remove from the back, so the remaining tids stay valid
+        for (auto rit = tids.rbegin(); rit != tids.rend(); ++rit)
+            remove(*rit);
+    }
+
+    inline void FrontCodedDictionaryColumn::clearContent() {
+        dictionary = FrontCodedDictionary();
+        pending.clear();
+        pending_codes.clear();
+        code_counts.clear();
+        values.clear();
+    }
+
+    inline ColumnType FrontCodedDictionaryColumn::get(TID tid) {
+        if (tid >= values.size())
+            throw std::out_of_range("FrontCodedDictionaryColumn::get(): invalid tid " + std::to_string(tid));
+        return decode(values[tid]);
+    }
+
+    inline std::string FrontCodedDictionaryColumn::operator[](const int index) {
+        return decode(values[index]);
+    }
+
+    inline void FrontCodedDictionaryColumn::decompress(TID begin, TID end, std::string *out) const {
+        std::vector<std::string> decoded;
+        if (end - begin >= dictionary.size()) {
+            decoded.reserve(dictionary.size());
+            std::vector<std::string> block_values;
+            for (size_t block = 0; block * FrontCodedDictionary::BLOCK_SIZE < dictionary.size(); block++) {
+                dictionary.decodeBlock(block, block_values);
+                std::move(block_values.begin(), block_values.end(), std::back_inserter(decoded));
+            }
+        }
+
+        constexpr TID CHUNK_SIZE = 1024;
+        uint32_t chunk[CHUNK_SIZE];
+        for (TID chunk_begin = begin; chunk_begin < end; chunk_begin += CHUNK_SIZE) {
+            TID chunk_end = std::min(chunk_begin + CHUNK_SIZE, end);
+            values.unpack(chunk_begin, chunk_end, chunk);
+            for (TID i = 0; i < chunk_end - chunk_begin; i++) {
+                uint32_t code = chunk[i];
+                if (code < decoded.size())
+                    *out++ = decoded[code];
+                else
+                    *out++ = decode(code);
+            }
+        }
+    }
+
+    inline std::string FrontCodedDictionaryColumn::print() const noexcept {
+        std::string str = "| " + this->name_ + " |\n________________________\n";
+        std::vector<std::string> column_values(values.size());
+        decompress(0, static_cast<TID>(values.size()), column_values.data());
+        for (const std::string &value: column_values)
+            str.append("| " + value + " |\n");
+        return str;
+    }
+
+    inline size_t FrontCodedDictionaryColumn::size() const noexcept {
+        return values.size();
+    }
+
+    inline size_t FrontCodedDictionaryColumn::getSizeInBytes() const noexcept {
+        size_t bytes = dictionary.getSizeInBytes() + values.getSizeInBytes() + code_counts.size() * sizeof(unsigned int);
+        // pending values are stored twice, in pending and as key of pending_codes
+        for (const std::string &value: pending)
+            bytes += 2 * (sizeof(std::string) + value.size()) + sizeof(uint32_t);
+        return bytes;
+    }
+
+    inline std::unique_ptr<ColumnBase> FrontCodedDictionaryColumn::copy() const {
+        return std::make_unique<FrontCodedDictionaryColumn>(*this);
+    }
+
+    inline void FrontCodedDictionaryColumn::store(const std::string &path) {
+        std::string path_(path);
+        path_ += this->name_;
+
+        std::ofstream outfile(path_.c_str(), std::ofstream::binary | std::ofstream::out | std::ofstream::trunc);
+        assert(outfile.is_open());
+        cereal::PortableBinaryOutputArchive oarchive(outfile);
+        oarchive(*this);
+    }
+
+    inline void FrontCodedDictionaryColumn::load(const std::string &path) {
+        std::string path_(path);
+        path_ += this->name_;
+
+        std::ifstream infile(path_.c_str(), std::ifstream::binary | std::ifstream::in);
+        cereal::PortableBinaryInputArchive ia(infile);
+        ia(*this);
+
+        rebuildIndex();
+        compact();
+    }
+
+    /***************** End of Implementation Section ******************/
+
+}// namespace CoGaDB
@@ -4,6 +4,8 @@
 #include "core/global_definitions.hpp"
 #include "cereal/types/vector.hpp"
 #include "cereal/types/tuple.hpp"
+#include <memory>
+#include <numeric>
 
 
 namespace CoGaDB {
@@ -49,6 +51,12 @@ namespace CoGaDB {
 
         T operator[](int index) final;
 
+        /*! \brief writes every run in the range with a single fill*/
+        void decompress(TID begin, TID end, T *out) const final;
+
+        /*! \brief sorts the runs instead of the rows and emits the tid range of every run*/
+        PositionList sort(SortOrder order) final;
+
         /**
          * @brief Serialization method called by Cereal. Implement this method in your compressed columns to get serialization working.
          */
@@ -58,22 +66,80 @@ namespace CoGaDB {
             archive(cntElements, values);// serialize things by passing them to the archive
         }
 
+    protected:
+        /*! \brief evaluates the predicate once per run, the returned scan emits the tids of all matching runs*/
+        typename ColumnBaseTyped<T>::RangeSelection prepareSelection(const T &value, ValueComparator comp) final;
+
+        /*! \brief evaluates the predicate once per run, the returned scan sets the bits of all matching runs as ranges*/
+        typename ColumnBaseTyped<T>::RangeBitmapSelection prepareBitmapSelection(const T &value, ValueComparator comp) final;
+
+        /*! \brief transforms the value of every run once and merges neighbouring runs that become equal*/
+        void applyScalar(ColumnAlgebraOperation op, const T &value) final;
+
     private:
+        /*! \brief returns one flag per run, which is set if the value of the run satisfies the predicate*/
+        std::shared_ptr<std::vector<char>> matchingRuns(const T &value, ValueComparator comp) const;
+
+        /*! \brief calls function(begin, end) for the part of every matching run inside [begin, end)*/
+        template<class Function>
+        void forEachMatchingRun(const std::vector<char> &matches, TID begin, TID end, Function function) const;
+
+        /*! \brief returns the index of the run containing position tid
+         *  \details checks the run of the previous lookup and its successor first, so sequential access does not
+         *  need a binary search*/
+        size_t findRun(TID tid);
+
+        /*! \brief returns the position of the first row of a run*/
+        TID runBegin(size_t run) const;
+
+        /*! \brief recomputes the run ends of all runs starting at index from*/
+        void rebuildRunEnds(size_t from);
+
         unsigned int cntElements = 0;
         std::vector<std::tuple<unsigned int, T>> values;
+        /*! prefix sums of the run lengths, run_ends[i] is the position behind the last row of run i*/
+        std::vector<TID> run_ends;
+        /*! run found by the last lookup*/
+        size_t cursor = 0;
     };
 
     /***************** Start of Implementation Section ******************/
 
     template<class T>
-    RunLengthCompressedColumn<T>::RunLengthCompressedColumn(const std::string &name) : CompressedColumn<T>(name), cntElements(), values() {
-        //TODO: implement
-        //values();            
+    RunLengthCompressedColumn<T>::RunLengthCompressedColumn(const std::string &name) : CompressedColumn<T>(name), cntElements(), values(), run_ends() {
     }
 
     template<class T>
     RunLengthCompressedColumn<T>::~RunLengthCompressedColumn() = default;
 
+    template<class T>
+    size_t RunLengthCompressedColumn<T>::findRun(TID tid) {
+        if (cursor < run_ends.size() && runBegin(cursor) <= tid) {
+            if (tid < run_ends[cursor])
+                return cursor;
+            if (cursor + 1 < run_ends.size() && tid < run_ends[cursor + 1])
+                return ++cursor;
+        }
+        cursor = std::upper_bound(run_ends.begin(), run_ends.end(), tid) - run_ends.begin();
+        return cursor;
+    }
+
+    template<class T>
+    TID RunLengthCompressedColumn<T>::runBegin(size_t run) const {
+        return run == 0 ? 0 : run_ends[run - 1];
+    }
+
+    template<class T>
+    void RunLengthCompressedColumn<T>::rebuildRunEnds(size_t from) {
+        run_ends.resize(values.size());
+        TID end = runBegin(from);
+        for (size_t i = from; i < values.size(); i++) {
+            end += std::get<0>(values[i]);
+            run_ends[i] = end;
+        }
+        cntElements = run_ends.empty() ? 0 : run_ends.back();
+    }
+
     template<class T>
     void RunLengthCompressedColumn<T>::insert(const ColumnType &new_Value) {
         //TODO: implement
@@ -85,14 +151,13 @@ namespace CoGaDB {
     template<class T>
     void RunLengthCompressedColumn<T>::insert(const T &new_value) {
         //TODO: implement
-        if(values.size() == 0) {
-            values.push_back(std::make_tuple(1, new_value));    //falls erstes Element, direkt hinzufügen mit 1
-        } 
-        else if (std::get<1>(values.back()) == new_value) {
+        if (!values.empty() && std::get<1>(values.back()) == new_value) {
             std::get<0>(values.back())++;                       //falls gleiches Element wie das letzte, Häufigkeit hochzählen
-        } 
+            run_ends.back()++;
+        }
         else {
             values.push_back(std::make_tuple(1, new_value));   //sonst anfügen mit Häufigkeit 1
+            run_ends.push_back(cntElements + 1);
         }
         cntElements++;
         return;
@@ -101,36 +166,46 @@ namespace CoGaDB {
     template<typename T>
     template<typename InputIterator>
     void RunLengthCompressedColumn<T>::insert(InputIterator first, InputIterator last) {
-        //TODO: implement
-        for (InputIterator i = first; i != last; ++i) { 
-            this->insert(i);                                //an eigentliche insert-Funktion übergeben
+        InputIterator i = first;
+        while (i != last) {
+            //Lauf gleicher Werte im Batch bestimmen und als Ganzes anfügen
+            T value = *i;
+            unsigned int length = 0;
+            do {
+                ++length;
+                ++i;
+            } while (i != last && *i == value);
+
+            if (!values.empty() && std::get<1>(values.back()) == value) {
+                std::get<0>(values.back()) += length;
+                run_ends.back() += length;
+            } else {
+                values.push_back(std::make_tuple(length, value));
+                run_ends.push_back(cntElements + length);
+            }
+            cntElements += length;
         }
         return;
     }
 
     template<class T>
     ColumnType RunLengthCompressedColumn<T>::get(TID tid) {
-        //TODO: implement
         if (cntElements > tid) {
-            unsigned int sum = 0;
-            for (unsigned int i = 0; i < values.size(); i++) {
-                sum += std::get<0>(values[i]);                       //Häufigkeiten aufsummieren
-
-                if (sum > tid) {
-                    return std::get<1>(values[i]);                  //falls tid kleiner als Summer der Häufigkeit wurd gesuchter Wert gefunden
-                }
-            }
+            return std::get<1>(values[findRun(tid)]);
         }
         return {};
     }
 
     template<class T>
     std::string RunLengthCompressedColumn<T>::print() const noexcept {
-        //TODO: implement
+        std::string str = "| " + this->name_ + " |\n________________________\n";
         for (unsigned int i = 0; i < values.size(); i++) {
-            std::cout << "Häufigkeit: " << std::get<0>(values[i]) << " Wert: " << std::get<1>(values[i]) << std::endl;
+            if constexpr(std::is_same_v<std::string, T>)
+                str.append("| " + std::to_string(std::get<0>(values[i])) + " x " + std::get<1>(values[i]) + " |\n");
+            else
+                str.append("| " + std::to_string(std::get<0>(values[i])) + " x " + std::to_string(std::get<1>(values[i])) + " |\n");
         }
-        return {};
+        return str;
     }
 
     template<class T>
@@ -147,43 +222,41 @@ namespace CoGaDB {
 
     template<class T>
     void RunLengthCompressedColumn<T>::update(TID tid, const ColumnType &new_value) {
-        //TODO: implement
-            unsigned sum = 0;
-            for (unsigned int i = 0; i < values.size(); i++) {
-                sum += std::get<0>(values[i]);                          //Häufigkeiten aufsummieren
-                if (sum > tid) {                                        //falls zu ersetzender Wert gefunden wurde:
-                    if (std::get<1>(values[i]) == std::get<T>(new_value)) {          //falls neuer Wert = alter Wert, nichts tun
-                        return;
-                    }
-                    if (std::get<0>(values[i]) == 1) {
-                        std::get<1>(values[i]) = std::get<T>(new_value);             //falls alte Häufigkeit = 1, Wert einfach ersetzen
-                        return;
-                    }
-
-                    std::vector<std::tuple<unsigned int, T>> new_values;
-
-                    for (unsigned int j = 0; j < cntElements; j++) {             //sonst alle Elemente umkopieren und gewünschtes Element ersetzen
-                        T value = std::get<T>(this->get(j));
-
-                        if (tid == j) {
-                            value = std::get<T>(new_value);
-                        }
-
-                        if (new_values.size() == 0) {
-                            new_values.push_back(std::make_tuple(1, value));
-                        } 
-                        else if (std::get<1>(new_values.back()) == value) {
-                            std::get<0>(new_values.back())++;
-                        } 
-                        else {
-                            new_values.push_back(std::make_tuple(1, value));
-                        }
-                    }
-                    values = new_values;
-                    return;
-                }
-            }
-        return;
+        if (cntElements <= tid) {
+            return;
+        }
+        T value = std::get<T>(new_value);
+        size_t run = findRun(tid);
+        T old_value = std::get<1>(values[run]);
+        if (old_value == value) {                                       //falls neuer Wert = alter Wert, nichts tun
+            return;
+        }
+        unsigned int length = std::get<0>(values[run]);
+        unsigned int offset = tid - runBegin(run);
+
+        //Lauf in [Anfang, tid), [tid] und (tid, Ende] aufteilen
+        std::vector<std::tuple<unsigned int, T>> pieces;
+        if (offset > 0) {
+            pieces.push_back(std::make_tuple(offset, old_value));
+        }
+        pieces.push_back(std::make_tuple(1, value));
+        if (offset + 1 < length) {
+            pieces.push_back(std::make_tuple(length - offset - 1, old_value));
+        }
+        values.erase(values.begin() + run);
+        values.insert(values.begin() + run, pieces.begin(), pieces.end());
+
+        //neuen Lauf mit gleichen Nachbarn zusammenfügen
+        size_t updated = run + (offset > 0 ? 1 : 0);
+        if (updated + 1 < values.size() && std::get<1>(values[updated + 1]) == value) {
+            std::get<0>(values[updated]) += std::get<0>(values[updated + 1]);
+            values.erase(values.begin() + updated + 1);
+        }
+        if (updated > 0 && std::get<1>(values[updated - 1]) == value) {
+            std::get<0>(values[updated - 1]) += std::get<0>(values[updated]);
+            values.erase(values.begin() + updated);
+        }
+        rebuildRunEnds(run > 0 ? run - 1 : 0);
     }
 
     template<class T>
@@ -198,44 +271,39 @@ namespace CoGaDB {
 
     template<class T>
     void RunLengthCompressedColumn<T>::remove(TID tid) {
-        //TODO: implement
-        unsigned int sum = 0;
-        for (unsigned int i = 0; i < values.size(); i++) {                 
-            sum += std::get<0>(values[i]);                                          //Häufigkeiten aufsummieren
-            if (sum > tid) {                                                        //falls zu ersetzender Wert gefunden wurde:
-                if (std::get<0>(values[i]) > 1) {                                   //falls Häufigkeit > 1, um 1 reduziere
-                    std::get<0>(values[i])--;
-                    cntElements--;
-                    return;
-                }
-                if (std::get<1>(values[i - 1]) == std::get<1>(values[i + 1])) {     //falls vor und nach dem Wert der gleiche Wert steht, 
-                    std::get<0>(values[i - 1]) += std::get<0>(values[i + 1]);       //  zusammenfügen und Wert entfernen
-                    values.erase(values.begin() + i + 1);
-                    values.erase(values.begin() + i);
-                    cntElements--;
-                    return;
-                }
-                values.erase(values.begin() + i);                                   //sonst Wert entfernen
-                cntElements--;
-                return;
+        if (cntElements <= tid) {
+            return;
+        }
+        size_t run = findRun(tid);
+        if (std::get<0>(values[run]) > 1) {                                     //falls Häufigkeit > 1, um 1 reduzieren
+            std::get<0>(values[run])--;
+            for (size_t i = run; i < run_ends.size(); i++) {
+                run_ends[i]--;
             }
+            cntElements--;
+            return;
         }
-        return;
+        values.erase(values.begin() + run);                                     //sonst Lauf entfernen
+        if (run > 0 && run < values.size() && std::get<1>(values[run - 1]) == std::get<1>(values[run])) {
+            std::get<0>(values[run - 1]) += std::get<0>(values[run]);           //falls vor und nach dem Wert der gleiche Wert steht,
+            values.erase(values.begin() + run);                                 //  zusammenfügen
+        }
+        rebuildRunEnds(run > 0 ? run - 1 : 0);
     }
 
     template<class T>
     void RunLengthCompressedColumn<T>::remove(PositionList &tid) {
-        //TODO: implement
-        for (unsigned int tid_: tid) {    
-            this->remove(tid_);               //an eigentliche remove-Funktion übergeben
+        for (auto rit = tid.rbegin(); rit != tid.rend(); ++rit) {
+            this->remove(*rit);               //von hinten entfernen, damit sich die übrigen tids nicht verschieben
         }
         return;
     }
 
     template<class T>
     void RunLengthCompressedColumn<T>::clearContent() {
-        //TODO: implement
         values.clear();
+        run_ends.clear();
+        cursor = 0;
         cntElements = 0;
         return;
     }
@@ -295,10 +363,7 @@ namespace CoGaDB {
         cereal::PortableBinaryInputArchive ia(infile);
         ia(values);
 
-        cntElements = 0;
-        for(unsigned int i = 0; i < values.size(); i++) {
-            cntElements += std::get<0>(values[i]);
-        } 
+        rebuildRunEnds(0);
         return;
 
     }
@@ -306,26 +371,110 @@ namespace CoGaDB {
 
     template<class T>
     T RunLengthCompressedColumn<T>::operator[](const int index) {
-        //TODO: implement
-        static T val;
         if ((int) cntElements > index) {
-            int sum = 0;
-            for (unsigned int i = 0; i < values.size(); i++) {                   //Häufigkeiten aufsummieren
-                sum += std::get<0>(values[i]);
-
-                if (sum > index) {                                      //falls Wert gefunden, ausgeben
-                    val = std::get<1>(values[i]);
-                    return val;
-                }
+            return std::get<1>(values[findRun(index)]);
+        }
+        return {};
+    }
+
+    template<class T>
+    PositionList RunLengthCompressedColumn<T>::sort(SortOrder order) {
+        //Läufe nach Wert sortieren, gleiche Werte bleiben nach ihrer Startposition geordnet
+        std::vector<size_t> runs(values.size());
+        std::iota(runs.begin(), runs.end(), 0);
+        std::stable_sort(runs.begin(), runs.end(), [this](size_t a, size_t b) { return std::get<1>(values[a]) < std::get<1>(values[b]); });
+
+        PositionList ids(cntElements);
+        auto out = ids.begin();
+        for (size_t run: runs) {
+            std::iota(out, out + std::get<0>(values[run]), runBegin(run));
+            out += std::get<0>(values[run]);
+        }
+
+        //absteigend ist die exakte Umkehrung der aufsteigenden Reihenfolge (Wert, tid)
+        if (order == DESCENDING)
+            std::reverse(ids.begin(), ids.end());
+        return ids;
+    }
+
+    template<class T>
+    void RunLengthCompressedColumn<T>::decompress(TID begin, TID end, T *out) const {
+        //Suche ohne cursor, damit parallele Aufrufe möglich sind
+        size_t run = std::upper_bound(run_ends.begin(), run_ends.end(), begin) - run_ends.begin();
+        for (TID pos = begin; pos < end; run++) {
+            TID run_end = std::min(run_ends[run], end);
+            out = std::fill_n(out, run_end - pos, std::get<1>(values[run]));
+            pos = run_end;
+        }
+    }
+
+    template<class T>
+    std::shared_ptr<std::vector<char>> RunLengthCompressedColumn<T>::matchingRuns(const T &value, const ValueComparator comp) const {
+        //Prädikat einmal pro Lauf auswerten
+        auto matches = std::make_shared<std::vector<char>>(values.size(), 0);
+        for (size_t i = 0; i < values.size(); i++) {
+            const T &run_value = std::get<1>(values[i]);
+            (*matches)[i] = comp == EQUAL ? run_value == value : (comp == LESSER ? run_value < value : run_value > value);
+        }
+        return matches;
+    }
+
+    template<class T>
+    template<class Function>
+    void RunLengthCompressedColumn<T>::forEachMatchingRun(const std::vector<char> &matches, TID begin, TID end,
+                                                          Function function) const {
+        size_t first_run = std::upper_bound(run_ends.begin(), run_ends.end(), begin) - run_ends.begin();
+        for (size_t i = first_run; i < run_ends.size() && runBegin(i) < end; i++) {
+            if (matches[i])
+                function(std::max(runBegin(i), begin), std::min(run_ends[i], end));
+        }
+    }
+
+    template<class T>
+    typename ColumnBaseTyped<T>::RangeSelection RunLengthCompressedColumn<T>::prepareSelection(const T &value, const ValueComparator comp) {
+        //passende Läufe innerhalb des Bereichs am Stück in tids expandieren
+        return [this, matches = matchingRuns(value, comp)](TID begin, TID end, PositionList &result_tids) {
+            forEachMatchingRun(*matches, begin, end, [&result_tids](TID run_begin, TID run_end) {
+                size_t offset = result_tids.size();
+                result_tids.resize(offset + (run_end - run_begin));
+                std::iota(result_tids.begin() + offset, result_tids.end(), run_begin);
+            });
+        };
+    }
+
+    template<class T>
+    typename ColumnBaseTyped<T>::RangeBitmapSelection RunLengthCompressedColumn<T>::prepareBitmapSelection(const T &value, const ValueComparator comp) {
+        //passende Läufe innerhalb des Bereichs als Bitbereiche setzen
+        return [this, matches = matchingRuns(value, comp)](TID begin, TID end, Bitmap &result) {
+            forEachMatchingRun(*matches, begin, end, [&result](TID run_begin, TID run_end) {
+                result.setRange(run_begin, run_end);
+            });
+        };
+    }
+
+    template<class T>
+    void RunLengthCompressedColumn<T>::applyScalar(ColumnAlgebraOperation op, const T &value) {
+        std::vector<std::tuple<unsigned int, T>> transformed;
+        transformed.reserve(values.size());
+        for (auto &run: values) {
+            T run_value = applyOperation(op, std::get<1>(run), value);
+            if (!transformed.empty() && std::get<1>(transformed.back()) == run_value) {   //Läufe mit gleichem Ergebnis verschmelzen
+                std::get<0>(transformed.back()) += std::get<0>(run);
+            } else {
+                transformed.emplace_back(std::get<0>(run), run_value);
             }
         }
-        return val;
+        values = std::move(transformed);
+        cursor = 0;
+        rebuildRunEnds(0);
     }
 
     template<class T>
     size_t RunLengthCompressedColumn<T>::getSizeInBytes() const noexcept {
-        //TODO: implement
-        return values.size() * (sizeof(T) + sizeof(int));
+        size_t bytes = values.size() * (sizeof(T) + sizeof(int)) + run_ends.size() * sizeof(TID);
+        for (const auto &run: values)
+            bytes += detail::heapBytes(std::get<1>(run));
+        return bytes;
     }
 
     /***************** End of Implementation Section ******************/
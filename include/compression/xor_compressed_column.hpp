@@ -0,0 +1,751 @@
+#pragma once
+
+#include "bit_packed_vector.hpp"
+#include "compressed_column.hpp"
+#include "frame_of_reference_kernels.hpp"
+#include "core/global_definitions.hpp"
+#include "core/selection_kernels.hpp"
+#include "cereal/types/vector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+
+namespace CoGaDB {
+
+    namespace detail {
+        /*! \brief appends values of up to 32 bits to a vector of 64 bit words, the first value starts a new word*/
+        class BitWriter {
+        public:
+            explicit BitWriter(std::vector<uint64_t> &words) : words(words), bit(0) {}
+
+            /*! \brief appends the low bits bits of value, value must not have higher bits set*/
+            void write(uint64_t value, unsigned int bits) {
+                if (bits == 0)
+                    return;
+                unsigned int offset = bit % 64;
+                if (offset == 0)
+                    words.push_back(0);
+                words.back() |= value << offset;
+                if (offset + bits > 64)
+                    words.push_back(value >> (64 - offset));
+                bit += bits;
+            }
+
+        private:
+            std::vector<uint64_t> &words;
+            size_t bit;
+        };
+
+        /*! \brief reads values of up to 32 bits from 64 bit words*/
+        class BitReader {
+        public:
+            explicit BitReader(const uint64_t *words) : words(words), bit(0) {}
+
+            uint64_t read(unsigned int bits) {
+                if (bits == 0)
+                    return 0;
+                size_t word = bit / 64;
+                unsigned int offset = bit % 64;
+                uint64_t value = words[word] >> offset;
+                if (offset + bits > 64)
+                    value |= words[word + 1] << (64 - offset);
+                bit += bits;
+                return value & ((uint64_t(1) << bits) - 1);
+            }
+
+            /*! \brief skips the next bits bits*/
+            void skip(size_t bits) {
+                bit += bits;
+            }
+
+        private:
+            const uint64_t *words;
+            size_t bit;
+        };
+    } // namespace detail
+
+    /*!
+     *  \brief This class represents a XOR compressed column with type T (float or int).
+     *  \details The rows are divided into blocks of BLOCK_SIZE values, every block is a bit stream in one of two
+     *  encodings, whichever is smaller for the block.
+     *
+     *  The XOR encoding starts with the bit pattern of the first value. Every following value is stored as XOR with its
+     *  predecessor (Gorilla): a single 0 bit if both are equal, otherwise the bits between the leading and trailing
+     *  zeros of the XOR, either inside the window of the previous XOR or with a new window. Slowly changing values
+     *  share sign, exponent and the high mantissa bits, so only few bits remain.
+     *
+     *  Floats with few decimal digits, such as sensor readings, have noisy mantissas and XOR badly. The decimal
+     *  encoding (ALP) multiplies the values of a block by 10^e and stores the resulting integers frame of reference
+     *  coded and bit-packed. A value v is encoded as d if float(d) / 10^e reproduces the bit pattern of v, all other
+     *  values, such as NaN, -0.0 or values with more digits, are stored as exceptions with their position and bit
+     *  pattern. The exponent is chosen from a sample of the block. Integers use the decimal encoding with e = 0.
+     *
+     *  Decoding is lossless in both encodings. The rows behind the last full block are kept unencoded. Every block
+     *  keeps its minimum and maximum, so selections skip blocks that cannot match and accept blocks that match
+     *  completely.
+     */
+    template<class T>
+    class XorCompressedColumn final : public CompressedColumn<T> {
+        static_assert(std::is_same_v<T, int> || std::is_same_v<T, float>,
+                      "Invalid type: XOR compression supports float and int");
+
+    public:
+        /*! \brief number of values per block*/
+        static constexpr TID BLOCK_SIZE = 256;
+        /*! \brief largest exponent of the decimal encoding, every power of ten up to 10^10 is exact as float*/
+        static constexpr unsigned int MAX_EXPONENT = std::is_same_v<T, float> ? 10 : 0;
+
+        /***************** constructors and destructor *****************/
+        explicit XorCompressedColumn(const std::string &name);
+
+        ~XorCompressedColumn() final;
+
+        void insert(const ColumnType &new_Value) final;
+
+        void insert(const T &new_value) final;
+
+        template<typename InputIterator>
+        void insert(InputIterator first, InputIterator last);
+
+        void update(TID tid, const ColumnType &new_value) final;
+
+        void update(PositionList &tid, const ColumnType &new_value) final;
+
+        void remove(TID tid) final;
+
+        // assumes tid list is sorted ascending
+        void remove(PositionList &tid) final;
+
+        void clearContent() final;
+
+        ColumnType get(TID tid) final;
+
+        std::string print() const noexcept final;
+
+        [[nodiscard]] size_t size() const noexcept final;
+
+        [[nodiscard]] size_t getSizeInBytes() const noexcept final;
+
+        [[nodiscard]] virtual std::unique_ptr<ColumnBase> copy() const;
+
+        void store(const std::string &path) final;
+
+        void load(const std::string &path) final;
+
+        T operator[](int index) final;
+
+        /*! \brief decodes the bit stream of every touched block once*/
+        void decompress(TID begin, TID end, T *out) const final;
+
+        /*! \brief returns the bytes a full block of the BLOCK_SIZE values starting at values takes in the column*/
+        static size_t encodedSizeInBytes(const T *values);
+
+        /**
+         * @brief Serialization method called by Cereal. Implement this method in your compressed columns to get serialization working.
+         */
+        template<class Archive>
+        void serialize(Archive &archive) {
+            archive(blocks, stream, tail);
+        }
+
+    protected:
+        /*! \brief decides per block from its minimum and maximum, only blocks that may partially match are decoded*/
+        typename ColumnBaseTyped<T>::RangeSelection prepareSelection(const T &value, ValueComparator comp) final;
+
+    private:
+        /*! exponent of blocks in the XOR encoding*/
+        static constexpr uint8_t XOR_ENCODED = 0xFF;
+        /*! bits of the header of a decimal block: reference, bit width and number of exceptions*/
+        static constexpr size_t DECIMAL_HEADER_BITS = 32 + 6 + 9;
+        /*! bits of an exception of a decimal block: position and bit pattern*/
+        static constexpr size_t EXCEPTION_BITS = 8 + 32;
+
+        struct Block {
+            /*! position of the first word of the block in stream*/
+            uint32_t word_offset;
+            /*! ordered keys of the minimum and the maximum*/
+            uint32_t min;
+            uint32_t max;
+            /*! exponent of the decimal encoding or XOR_ENCODED*/
+            uint8_t exponent;
+
+            template<class Archive>
+            void serialize(Archive &archive) {
+                archive(word_offset, min, max, exponent);
+            }
+        };
+
+        /*! parameters of the decimal encoding of a block*/
+        struct DecimalEncoding {
+            unsigned int exponent;
+            int32_t reference;
+            unsigned int bit_width;
+            size_t bits;
+        };
+
+        /*! \brief returns the bit pattern of value*/
+        static uint32_t toBits(const T &value);
+
+        static T fromBits(uint32_t bits);
+
+        /*! \brief stores the decimal digits of the value with bit pattern bits and exponent in digits, returns false if
+         * the value does not round trip*/
+        static bool toDecimal(uint32_t bits, unsigned int exponent, int32_t &digits);
+
+        /*! \brief returns the bit pattern of the value with decimal digits and exponent*/
+        static uint32_t fromDecimal(int32_t digits, unsigned int exponent);
+
+        /*! \brief returns the bits of the XOR encoding of the bit patterns of BLOCK_SIZE values*/
+        static size_t xorBits(const uint32_t *bits);
+
+        /*! \brief returns the cheapest decimal encoding of the bit patterns of BLOCK_SIZE values among the exponents
+         * that the values of a sample need to round trip*/
+        static DecimalEncoding chooseDecimalEncoding(const uint32_t *bits);
+
+        static void writeXor(const uint32_t *bits, std::vector<uint64_t> &words);
+
+        static void writeDecimal(const uint32_t *bits, const DecimalEncoding &encoding, std::vector<uint64_t> &words);
+
+        /*! \brief encodes the bit patterns of BLOCK_SIZE values and appends the stream to words*/
+        static Block encodeBlock(const uint32_t *bits, std::vector<uint64_t> &words);
+
+        /*! \brief writes the bit patterns of the first count values of the block with index block to bits*/
+        void decodeBlock(size_t block, uint32_t *bits, size_t count = BLOCK_SIZE) const;
+
+        /*! \brief returns the number of words of the stream of the block with index block*/
+        size_t wordsOf(size_t block) const;
+
+        /*! \brief re-encodes the block with index block from the bit patterns of BLOCK_SIZE values*/
+        void replaceBlock(size_t block, const uint32_t *bits);
+
+        /*! \brief appends bit patterns to the unencoded rows and encodes every block that becomes full*/
+        void appendBits(const std::vector<uint32_t> &bits);
+
+        /*! \brief returns the bit patterns of all rows starting with the block with index first_block*/
+        std::vector<uint32_t> bitsFrom(size_t first_block) const;
+
+        /*! \brief drops all rows starting with the block with index first_block*/
+        void truncate(size_t first_block);
+
+        std::vector<Block> blocks;
+        /*! bit streams of all blocks, every block starts at a word boundary*/
+        std::vector<uint64_t> stream;
+        /*! bit patterns of the rows behind the last full block*/
+        std::vector<uint32_t> tail;
+    };
+
+    /***************** Start of Implementation Section ******************/
+
+    template<class T>
+    XorCompressedColumn<T>::XorCompressedColumn(const std::string &name)
+            : CompressedColumn<T>(name), blocks(), stream(), tail() {
+    }
+
+    template<class T>
+    XorCompressedColumn<T>::~XorCompressedColumn() = default;
+
+    template<class T>
+    uint32_t XorCompressedColumn<T>::toBits(const T &value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    template<class T>
+    T XorCompressedColumn<T>::fromBits(uint32_t bits) {
+        T value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    template<class T>
+    bool XorCompressedColumn<T>::toDecimal(uint32_t bits, unsigned int exponent, int32_t &digits) {
+        if constexpr(std::is_same_v<T, float>) {
+            constexpr double POWERS_OF_TEN[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10};
+            double scaled = static_cast<double>(fromBits(bits)) * POWERS_OF_TEN[exponent];
+            // also rejects NaN
+            if (!(std::fabs(scaled) < 2147483647.0))
+                return false;
+            digits = static_cast<int32_t>(std::lround(scaled));
+            return fromDecimal(digits, exponent) == bits;
+        } else {
+            digits = static_cast<int32_t>(bits);
+            return true;
+        }
+    }
+
+    template<class T>
+    uint32_t XorCompressedColumn<T>::fromDecimal(int32_t digits, unsigned int exponent) {
+        if constexpr(std::is_same_v<T, float>) {
+            // both operands are exact as long as the digits fit into the mantissa, so the quotient is the float
+            // nearest to the decimal number, which is also what parsing it yields
+            constexpr float POWERS_OF_TEN[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+            return toBits(static_cast<float>(digits) / POWERS_OF_TEN[exponent]);
+        } else {
+            return static_cast<uint32_t>(digits);
+        }
+    }
+
+    template<class T>
+    size_t XorCompressedColumn<T>::xorBits(const uint32_t *bits) {
+        size_t result = 32;
+        unsigned int leading = 33, trailing = 33;
+        for (size_t i = 1; i < BLOCK_SIZE; i++) {
+            uint32_t x = bits[i] ^ bits[i - 1];
+            if (x == 0) {
+                result++;
+                continue;
+            }
+            unsigned int new_leading = __builtin_clz(x), new_trailing = __builtin_ctz(x);
+            if (new_leading < leading || new_trailing < trailing) {
+                leading = new_leading;
+                trailing = new_trailing;
+                result += 10;
+            }
+            result += 2 + 32 - leading - trailing;
+        }
+        return result;
+    }
+
+    template<class T>
+    typename XorCompressedColumn<T>::DecimalEncoding XorCompressedColumn<T>::chooseDecimalEncoding(const uint32_t *bits) {
+        // every sampled value proposes the smallest exponent it round trips with
+        constexpr size_t SAMPLE_SIZE = 8;
+        unsigned int exponents[SAMPLE_SIZE];
+        size_t number_of_exponents = 0;
+        for (size_t i = 0; i < BLOCK_SIZE; i += BLOCK_SIZE / SAMPLE_SIZE) {
+            int32_t digits;
+            for (unsigned int exponent = 0; exponent <= MAX_EXPONENT; exponent++) {
+                if (toDecimal(bits[i], exponent, digits)) {
+                    if (std::find(exponents, exponents + number_of_exponents, exponent) == exponents + number_of_exponents)
+                        exponents[number_of_exponents++] = exponent;
+                    break;
+                }
+            }
+        }
+
+        DecimalEncoding best{0, 0, 0, std::numeric_limits<size_t>::max()};
+        for (size_t e = 0; e < number_of_exponents; e++) {
+            unsigned int exponent = exponents[e];
+            int64_t min = std::numeric_limits<int32_t>::max(), max = std::numeric_limits<int32_t>::min();
+            size_t exceptions = 0;
+            for (size_t i = 0; i < BLOCK_SIZE; i++) {
+                int32_t digits;
+                if (toDecimal(bits[i], exponent, digits)) {
+                    min = std::min<int64_t>(min, digits);
+                    max = std::max<int64_t>(max, digits);
+                } else {
+                    exceptions++;
+                }
+            }
+            if (exceptions == BLOCK_SIZE)
+                continue;
+            unsigned int bit_width = BitPackedVector::requiredBits(static_cast<uint32_t>(max - min));
+            size_t encoded_bits = DECIMAL_HEADER_BITS + BLOCK_SIZE * bit_width + exceptions * EXCEPTION_BITS;
+            if (encoded_bits < best.bits)
+                best = {exponent, static_cast<int32_t>(min), bit_width, encoded_bits};
+        }
+        return best;
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::writeXor(const uint32_t *bits, std::vector<uint64_t> &words) {
+        detail::BitWriter writer(words);
+        writer.write(bits[0], 32);
+        // window of meaningful bits of the previous XOR, no window exists before the first one
+        unsigned int leading = 33, trailing = 33;
+        for (size_t i = 1; i < BLOCK_SIZE; i++) {
+            uint32_t x = bits[i] ^ bits[i - 1];
+            if (x == 0) {
+                writer.write(0, 1);
+                continue;
+            }
+            unsigned int new_leading = __builtin_clz(x), new_trailing = __builtin_ctz(x);
+            if (new_leading >= leading && new_trailing >= trailing) {
+                // control bits 01: the XOR fits into the previous window
+                writer.write(1, 2);
+            } else {
+                // control bits 11, 5 bits leading zeros, 5 bits number of meaningful bits - 1
+                leading = new_leading;
+                trailing = new_trailing;
+                writer.write(3, 2);
+                writer.write(leading, 5);
+                writer.write(31 - leading - trailing, 5);
+            }
+            writer.write(x >> trailing, 32 - leading - trailing);
+        }
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::writeDecimal(const uint32_t *bits, const DecimalEncoding &encoding,
+                                              std::vector<uint64_t> &words) {
+        // exceptions keep the offset 0 and are patched after unpacking
+        uint32_t offsets[BLOCK_SIZE];
+        std::vector<uint8_t> exceptions;
+        for (size_t i = 0; i < BLOCK_SIZE; i++) {
+            int32_t digits;
+            if (toDecimal(bits[i], encoding.exponent, digits)) {
+                offsets[i] = static_cast<uint32_t>(digits) - static_cast<uint32_t>(encoding.reference);
+            } else {
+                offsets[i] = 0;
+                exceptions.push_back(static_cast<uint8_t>(i));
+            }
+        }
+
+        detail::BitWriter writer(words);
+        writer.write(static_cast<uint32_t>(encoding.reference), 32);
+        writer.write(encoding.bit_width, 6);
+        writer.write(exceptions.size(), 9);
+        for (uint32_t offset: offsets)
+            writer.write(offset, encoding.bit_width);
+        for (uint8_t position: exceptions) {
+            writer.write(position, 8);
+            writer.write(bits[position], 32);
+        }
+    }
+
+    template<class T>
+    typename XorCompressedColumn<T>::Block XorCompressedColumn<T>::encodeBlock(const uint32_t *bits, std::vector<uint64_t> &words) {
+        Block block{static_cast<uint32_t>(words.size()), ~uint32_t(0), 0, XOR_ENCODED};
+        for (size_t i = 0; i < BLOCK_SIZE; i++) {
+            uint32_t key = orderedKey(fromBits(bits[i]));
+            block.min = std::min(block.min, key);
+            block.max = std::max(block.max, key);
+        }
+
+        DecimalEncoding decimal = chooseDecimalEncoding(bits);
+        if (decimal.bits < xorBits(bits)) {
+            block.exponent = static_cast<uint8_t>(decimal.exponent);
+            writeDecimal(bits, decimal, words);
+        } else {
+            writeXor(bits, words);
+        }
+        return block;
+    }
+
+    template<class T>
+    size_t XorCompressedColumn<T>::encodedSizeInBytes(const T *values) {
+        uint32_t bits[BLOCK_SIZE];
+        for (size_t i = 0; i < BLOCK_SIZE; i++)
+            bits[i] = toBits(values[i]);
+        size_t encoded_bits = std::min(chooseDecimalEncoding(bits).bits, xorBits(bits));
+        return (encoded_bits + 63) / 64 * sizeof(uint64_t) + sizeof(Block);
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::decodeBlock(size_t block, uint32_t *bits, size_t count) const {
+        detail::BitReader reader(stream.data() + blocks[block].word_offset);
+        unsigned int exponent = blocks[block].exponent;
+        if (exponent != XOR_ENCODED) {
+            auto reference = static_cast<uint32_t>(reader.read(32));
+            auto bit_width = static_cast<unsigned int>(reader.read(6));
+            auto exceptions = static_cast<size_t>(reader.read(9));
+            for (size_t i = 0; i < count; i++)
+                bits[i] = fromDecimal(static_cast<int32_t>(reference + static_cast<uint32_t>(reader.read(bit_width))),
+                                      exponent);
+            reader.skip((BLOCK_SIZE - count) * bit_width);
+            for (size_t e = 0; e < exceptions; e++) {
+                auto position = static_cast<size_t>(reader.read(8));
+                auto value = static_cast<uint32_t>(reader.read(32));
+                if (position < count)
+                    bits[position] = value;
+            }
+            return;
+        }
+
+        auto value = static_cast<uint32_t>(reader.read(32));
+        bits[0] = value;
+        unsigned int leading = 0, trailing = 0;
+        for (size_t i = 1; i < count; i++) {
+            if (reader.read(1)) {
+                if (reader.read(1)) {
+                    leading = static_cast<unsigned int>(reader.read(5));
+                    trailing = 31 - leading - static_cast<unsigned int>(reader.read(5));
+                }
+                value ^= static_cast<uint32_t>(reader.read(32 - leading - trailing)) << trailing;
+            }
+            bits[i] = value;
+        }
+    }
+
+    template<class T>
+    size_t XorCompressedColumn<T>::wordsOf(size_t block) const {
+        size_t end = block + 1 < blocks.size() ? blocks[block + 1].word_offset : stream.size();
+        return end - blocks[block].word_offset;
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::replaceBlock(size_t block, const uint32_t *bits) {
+        std::vector<uint64_t> words;
+        Block new_block = encodeBlock(bits, words);
+        new_block.word_offset = blocks[block].word_offset;
+
+        // splice the new stream in place of the old one and move the following blocks
+        size_t old_words = wordsOf(block);
+        auto first = stream.begin() + blocks[block].word_offset;
+        if (old_words == words.size()) {
+            std::copy(words.begin(), words.end(), first);
+        } else {
+            stream.erase(first, first + old_words);
+            stream.insert(stream.begin() + new_block.word_offset, words.begin(), words.end());
+        }
+        auto difference = static_cast<int64_t>(words.size()) - static_cast<int64_t>(old_words);
+        blocks[block] = new_block;
+        for (size_t b = block + 1; b < blocks.size(); b++)
+            blocks[b].word_offset = static_cast<uint32_t>(blocks[b].word_offset + difference);
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::appendBits(const std::vector<uint32_t> &bits) {
+        for (uint32_t value: bits) {
+            tail.push_back(value);
+            if (tail.size() == BLOCK_SIZE) {
+                blocks.push_back(encodeBlock(tail.data(), stream));
+                tail.clear();
+            }
+        }
+    }
+
+    template<class T>
+    std::vector<uint32_t> XorCompressedColumn<T>::bitsFrom(size_t first_block) const {
+        std::vector<uint32_t> bits((blocks.size() - first_block) * BLOCK_SIZE);
+        for (size_t block = first_block; block < blocks.size(); block++)
+            decodeBlock(block, bits.data() + (block - first_block) * BLOCK_SIZE);
+        bits.insert(bits.end(), tail.begin(), tail.end());
+        return bits;
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::truncate(size_t first_block) {
+        if (first_block < blocks.size()) {
+            stream.resize(blocks[first_block].word_offset);
+            blocks.resize(first_block);
+        }
+        tail.clear();
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::insert(const ColumnType &new_Value) {
+        this->insert(std::get<T>(new_Value));
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::insert(const T &new_value) {
+        tail.push_back(toBits(new_value));
+        if (tail.size() == BLOCK_SIZE) {
+            blocks.push_back(encodeBlock(tail.data(), stream));
+            tail.clear();
+        }
+    }
+
+    template<typename T>
+    template<typename InputIterator>
+    void XorCompressedColumn<T>::insert(InputIterator first, InputIterator last) {
+        for (InputIterator i = first; i != last; ++i)
+            this->insert(*i);
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::update(TID tid, const ColumnType &new_value) {
+        if (tid >= size())
+            throw std::out_of_range("XorCompressedColumn::update(): invalid tid " + std::to_string(tid));
+
+        uint32_t bits = toBits(std::get<T>(new_value));
+        size_t block = tid / BLOCK_SIZE;
+        if (block >= blocks.size()) {
+            tail[tid - blocks.size() * BLOCK_SIZE] = bits;
+            return;
+        }
+        uint32_t values[BLOCK_SIZE];
+        decodeBlock(block, values);
+        values[tid % BLOCK_SIZE] = bits;
+        replaceBlock(block, values);
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::update(PositionList &tids, const ColumnType &new_value) {
+        for (TID tid: tids)
+            update(tid, new_value);
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::remove(TID tid) {
+        if (tid >= size())
+            throw std::out_of_range("XorCompressedColumn::remove(): invalid tid " + std::to_string(tid));
+
+        // all following rows move to the front, so every block starting with the one of tid is re-encoded
+        size_t block = tid / BLOCK_SIZE;
+        std::vector<uint32_t> bits = bitsFrom(block);
+        bits.erase(bits.begin() + (tid - block * BLOCK_SIZE));
+        truncate(block);
+        appendBits(bits);
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::remove(PositionList &tids) {
+        if (tids.empty())
+            return;
+        size_t first_block = tids.front() / BLOCK_SIZE;
+        std::vector<uint32_t> bits = bitsFrom(first_block);
+        std::vector<uint32_t> remaining;
+        remaining.reserve(bits.size());
+        auto next = tids.begin();
+        for (size_t i = 0; i < bits.size(); i++) {
+            if (next != tids.end() && *next == first_block * BLOCK_SIZE + i) {
+                ++next;
+                continue;
+            }
+            remaining.push_back(bits[i]);
+        }
+        truncate(first_block);
+        appendBits(remaining);
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::clearContent() {
+        blocks.clear();
+        stream.clear();
+        tail.clear();
+    }
+
+    template<class T>
+    ColumnType XorCompressedColumn<T>::get(TID tid) {
+        if (tid >= size())
+            throw std::out_of_range("XorCompressedColumn::get(): invalid tid " + std::to_string(tid));
+        return (*this)[tid];
+    }
+
+    template<class T>
+    T XorCompressedColumn<T>::operator[](const int index) {
+        auto tid = static_cast<TID>(index);
+        size_t block = tid / BLOCK_SIZE;
+        if (block >= blocks.size())
+            return fromBits(tail[tid - blocks.size() * BLOCK_SIZE]);
+        // the stream is decoded up to the row only
+        uint32_t bits[BLOCK_SIZE];
+        decodeBlock(block, bits, tid % BLOCK_SIZE + 1);
+        return fromBits(bits[tid % BLOCK_SIZE]);
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::decompress(TID begin, TID end, T *out) const {
+        uint32_t bits[BLOCK_SIZE];
+        for (TID tid = begin; tid < end;) {
+            size_t block = tid / BLOCK_SIZE;
+            TID block_begin = static_cast<TID>(block * BLOCK_SIZE);
+            TID last = std::min<TID>(end, block_begin + BLOCK_SIZE);
+            const uint32_t *block_bits = bits;
+            if (block < blocks.size())
+                decodeBlock(block, bits, last - block_begin);
+            else
+                block_bits = tail.data();
+            for (; tid < last; tid++)
+                *out++ = fromBits(block_bits[tid - block_begin]);
+        }
+    }
+
+    template<class T>
+    typename ColumnBaseTyped<T>::RangeSelection XorCompressedColumn<T>::prepareSelection(const T &value, const ValueComparator comp) {
+        return [this, value, comp](TID begin, TID end, PositionList &result_tids) {
+            uint32_t bits[BLOCK_SIZE];
+            T values[BLOCK_SIZE];
+            for (TID block_begin = begin - begin % BLOCK_SIZE; block_begin < end; block_begin += BLOCK_SIZE) {
+                TID first = std::max(begin, block_begin), last = std::min<TID>(end, block_begin + BLOCK_SIZE);
+                size_t block = block_begin / BLOCK_SIZE;
+                const uint32_t *block_bits = bits;
+                if (block < blocks.size()) {
+                    // the bounds are compared like the values, NaN bounds never decide a block completely
+                    T min = fromOrderedKey<T>(blocks[block].min), max = fromOrderedKey<T>(blocks[block].max);
+                    bool ordered = true;
+                    if constexpr(std::is_same_v<T, float>)
+                        ordered = !std::isnan(min) && !std::isnan(max);
+                    bool none, all;
+                    if (comp == EQUAL) {
+                        none = value < min || max < value;
+                        all = ordered && min == value && max == value;
+                    } else if (comp == LESSER) {
+                        none = value <= min;
+                        all = ordered && max < value;
+                    } else {
+                        none = max <= value;
+                        all = ordered && value < min;
+                    }
+                    if (none)
+                        continue;
+                    if (all) {
+                        size_t offset = result_tids.size();
+                        result_tids.resize(offset + (last - first));
+                        std::iota(result_tids.begin() + offset, result_tids.end(), first);
+                        continue;
+                    }
+                    decodeBlock(block, bits, last - block_begin);
+                } else {
+                    block_bits = tail.data();
+                }
+                for (TID i = first - block_begin; i < last - block_begin; i++)
+                    values[i] = fromBits(block_bits[i]);
+                size_t offset = result_tids.size();
+                result_tids.resize(offset + (last - first));
+                TID *out = result_tids.data() + offset;
+                size_t count = selectValues(values, first - block_begin, last - block_begin, value, comp, out);
+                for (size_t i = 0; i < count; i++)
+                    out[i] += block_begin;
+                result_tids.resize(offset + count);
+            }
+        };
+    }
+
+    template<class T>
+    std::string XorCompressedColumn<T>::print() const noexcept {
+        std::string str = "| " + this->name_ + " |\n________________________\n";
+        std::vector<T> values(size());
+        decompress(0, static_cast<TID>(values.size()), values.data());
+        for (const T &value: values)
+            str.append("| " + std::to_string(value) + " |\n");
+        return str;
+    }
+
+    template<class T>
+    size_t XorCompressedColumn<T>::size() const noexcept {
+        return blocks.size() * BLOCK_SIZE + tail.size();
+    }
+
+    template<class T>
+    size_t XorCompressedColumn<T>::getSizeInBytes() const noexcept {
+        return blocks.size() * sizeof(Block) + stream.size() * sizeof(uint64_t) + tail.size() * sizeof(uint32_t);
+    }
+
+    template<class T>
+    std::unique_ptr<ColumnBase> XorCompressedColumn<T>::copy() const {
+        return std::make_unique<XorCompressedColumn<T>>(*this);
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::store(const std::string &path) {
+        std::string path_(path);
+        path_ += this->name_;
+
+        std::ofstream outfile(path_.c_str(), std::ofstream::binary | std::ofstream::out | std::ofstream::trunc);
+        assert(outfile.is_open());
+        cereal::PortableBinaryOutputArchive oarchive(outfile);
+        oarchive(*this);
+    }
+
+    template<class T>
+    void XorCompressedColumn<T>::load(const std::string &path) {
+        std::string path_(path);
+        path_ += this->name_;
+
+        std::ifstream infile(path_.c_str(), std::ifstream::binary | std::ifstream::in);
+        cereal::PortableBinaryInputArchive ia(infile);
+        ia(*this);
+    }
+
+    /***************** End of Implementation Section ******************/
+
+}// namespace CoGaDB
@@ -1,6 +1,7 @@
 #pragma once
 // CoGaDB includes
 #include <cstddef>                     // for size_t
+#include <core/bitmap.hpp>              // for Bitmap
 #include <core/global_definitions.hpp>  // for ColumnType, TID, SortOrder
 #include <iosfwd>                       // for ostream
 #include <memory>                       // for unique_ptr
@@ -84,6 +85,10 @@ namespace CoGaDB {
                                                 ValueComparator comp,
                                                 unsigned int number_of_threads) = 0;
 
+        /*! \brief filters the values of a column according to a filter condition consisting of a comparison value and a
+         * ValueComparator (=,<,>) \return Bitmap with one bit per row, which is set if the row qualifies*/
+        virtual Bitmap bitmap_selection(const ColumnType &value_for_comparison, ValueComparator comp) = 0;
+
         /*! \brief joins two columns using the hash join algorithm
          * \return PositionListPairPtr to a PositionListPair, which represents the result*/
         virtual PositionListPair hash_join(ColumnBase &join_column) = 0;
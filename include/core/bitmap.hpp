@@ -0,0 +1,229 @@
+#pragma once
+
+#include <core/global_definitions.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace CoGaDB {
+
+    /*!
+     *  \brief This class represents the result of a selection as one bit per row of a column.
+     *  \details Bit i is set if row i qualifies. Bitmaps of the same size are combined word by word, so conjunctions
+     *  and disjunctions of predicates on columns of the same table do not need to intersect sorted tid lists. Bits
+     *  behind the last row are always zero.
+     */
+    class Bitmap {
+    public:
+        /***************** constructors and destructor *****************/
+        /*! \brief creates a bitmap of size rows without any bit set*/
+        explicit Bitmap(size_t size = 0) : size_(size), words_((size + 63) / 64, 0) {}
+
+        /*! \brief creates a bitmap of size rows with the bits of tids set*/
+        static Bitmap fromPositionList(const std::vector<TID> &tids, size_t size);
+
+        /*! \brief returns the positions of all set bits in ascending order*/
+        [[nodiscard]] std::vector<TID> toPositionList() const;
+
+        [[nodiscard]] bool test(size_t index) const { return (words_[index / 64] >> (index % 64)) & 1; }
+
+        void set(size_t index) { words_[index / 64] |= uint64_t(1) << (index % 64); }
+
+        void reset(size_t index) { words_[index / 64] &= ~(uint64_t(1) << (index % 64)); }
+
+        /*! \brief sets the bits of all positions in tids*/
+        void set(const std::vector<TID> &tids);
+
+        /*! \brief sets the bits of all positions in [begin, end)*/
+        void setRange(size_t begin, size_t end);
+
+        /*! \brief changes the number of rows, new bits are not set*/
+        void resize(size_t size);
+
+        /*! \brief removes the bit at index, the bits behind it move one position to the front*/
+        void erase(size_t index);
+
+        /*! \brief inverts all bits*/
+        void flip();
+
+        /*! \brief inverts the bits of all positions in [begin, end)*/
+        void flipRange(size_t begin, size_t end);
+
+        /*! \brief sets the bits of all positions in [begin, end) that are set in other, throws if the sizes differ*/
+        void orRange(const Bitmap &other, size_t begin, size_t end);
+
+        /*! \brief returns the number of rows the bitmap covers*/
+        [[nodiscard]] size_t size() const noexcept { return size_; }
+
+        /*! \brief returns the number of set bits*/
+        [[nodiscard]] size_t count() const noexcept;
+
+        [[nodiscard]] const std::vector<uint64_t> &words() const noexcept { return words_; }
+
+        /*! \brief returns the words for writing them directly, the bits behind the last row have to stay zero*/
+        [[nodiscard]] uint64_t *data() noexcept { return words_.data(); }
+
+        /*! \brief keeps the bits that are set in both bitmaps, throws if the sizes differ*/
+        Bitmap &operator&=(const Bitmap &other);
+
+        /*! \brief keeps the bits that are set in one of both bitmaps, throws if the sizes differ*/
+        Bitmap &operator|=(const Bitmap &other);
+
+        /*! \brief clears the bits that are set in other, throws if the sizes differ*/
+        Bitmap &andNot(const Bitmap &other);
+
+        bool operator==(const Bitmap &other) const { return size_ == other.size_ && words_ == other.words_; }
+
+        bool operator!=(const Bitmap &other) const { return !(*this == other); }
+
+        template<class Archive>
+        void serialize(Archive &archive) {
+            archive(size_, words_);
+        }
+
+    private:
+        void checkSize(const Bitmap &other) const;
+
+        /*! \brief clears the bits behind the last row*/
+        void clearTail();
+
+        /*! \brief calls update(word, mask) for every word overlapping [begin, end), mask selects the bits of the range*/
+        template<class Update>
+        void updateRange(size_t begin, size_t end, Update update);
+
+        size_t size_;
+        std::vector<uint64_t> words_;
+    };
+
+    inline Bitmap operator&(Bitmap left, const Bitmap &right) { return left &= right; }
+
+    inline Bitmap operator|(Bitmap left, const Bitmap &right) { return left |= right; }
+
+    /***************** Start of Implementation Section ******************/
+
+    inline Bitmap Bitmap::fromPositionList(const std::vector<TID> &tids, size_t size) {
+        Bitmap bitmap(size);
+        bitmap.set(tids);
+        return bitmap;
+    }
+
+    inline std::vector<TID> Bitmap::toPositionList() const {
+        std::vector<TID> tids;
+        tids.reserve(count());
+        for (size_t w = 0; w < words_.size(); w++) {
+            for (uint64_t word = words_[w]; word != 0; word &= word - 1)
+                tids.push_back(static_cast<TID>(w * 64 + __builtin_ctzll(word)));
+        }
+        return tids;
+    }
+
+    inline void Bitmap::set(const std::vector<TID> &tids) {
+        for (TID tid: tids) {
+            if (tid >= size_)
+                throw std::out_of_range("Bitmap::set(): invalid tid " + std::to_string(tid));
+            set(static_cast<size_t>(tid));
+        }
+    }
+
+    template<class Update>
+    void Bitmap::updateRange(size_t begin, size_t end, Update update) {
+        if (begin >= end)
+            return;
+        if (end > size_)
+            throw std::out_of_range("Bitmap: invalid end " + std::to_string(end));
+        size_t first = begin / 64, last = (end - 1) / 64;
+        uint64_t first_mask = ~uint64_t(0) << (begin % 64);
+        uint64_t last_mask = ~uint64_t(0) >> (63 - (end - 1) % 64);
+        if (first == last) {
+            update(first, first_mask & last_mask);
+            return;
+        }
+        update(first, first_mask);
+        for (size_t w = first + 1; w < last; w++)
+            update(w, ~uint64_t(0));
+        update(last, last_mask);
+    }
+
+    inline void Bitmap::setRange(size_t begin, size_t end) {
+        updateRange(begin, end, [this](size_t w, uint64_t mask) { words_[w] |= mask; });
+    }
+
+    inline void Bitmap::flipRange(size_t begin, size_t end) {
+        updateRange(begin, end, [this](size_t w, uint64_t mask) { words_[w] ^= mask; });
+    }
+
+    inline void Bitmap::orRange(const Bitmap &other, size_t begin, size_t end) {
+        checkSize(other);
+        updateRange(begin, end, [this, &other](size_t w, uint64_t mask) { words_[w] |= other.words_[w] & mask; });
+    }
+
+    inline void Bitmap::resize(size_t size) {
+        size_ = size;
+        words_.resize((size + 63) / 64, 0);
+        clearTail();
+    }
+
+    inline void Bitmap::erase(size_t index) {
+        if (index >= size_)
+            throw std::out_of_range("Bitmap::erase(): invalid index " + std::to_string(index));
+        size_t first = index / 64, bit = index % 64;
+        uint64_t low = words_[first] & ((uint64_t(1) << bit) - 1);
+        uint64_t high = bit == 63 ? 0 : (words_[first] >> (bit + 1)) << bit;
+        words_[first] = low | high;
+        for (size_t w = first + 1; w < words_.size(); w++) {
+            words_[w - 1] |= (words_[w] & 1) << 63;
+            words_[w] >>= 1;
+        }
+        resize(size_ - 1);
+    }
+
+    inline void Bitmap::flip() {
+        for (uint64_t &word: words_)
+            word = ~word;
+        clearTail();
+    }
+
+    inline size_t Bitmap::count() const noexcept {
+        size_t bits = 0;
+        for (uint64_t word: words_)
+            bits += __builtin_popcountll(word);
+        return bits;
+    }
+
+    inline Bitmap &Bitmap::operator&=(const Bitmap &other) {
+        checkSize(other);
+        for (size_t w = 0; w < words_.size(); w++)
+            words_[w] &= other.words_[w];
+        return *this;
+    }
+
+    inline Bitmap &Bitmap::operator|=(const Bitmap &other) {
+        checkSize(other);
+        for (size_t w = 0; w < words_.size(); w++)
+            words_[w] |= other.words_[w];
+        return *this;
+    }
+
+    inline Bitmap &Bitmap::andNot(const Bitmap &other) {
+        checkSize(other);
+        for (size_t w = 0; w < words_.size(); w++)
+            words_[w] &= ~other.words_[w];
+        return *this;
+    }
+
+    inline void Bitmap::clearTail() {
+        if (size_ % 64 != 0)
+            words_.back() &= (uint64_t(1) << (size_ % 64)) - 1;
+    }
+
+    inline void Bitmap::checkSize(const Bitmap &other) const {
+        if (size_ != other.size_)
+            throw std::invalid_argument("Bitmap: sizes " + std::to_string(size_) + " and " +
+                                        std::to_string(other.size_) + " differ");
+    }
+
+    /***************** End of Implementation Section ******************/
+
+} // namespace CoGaDB
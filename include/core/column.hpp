@@ -4,6 +4,7 @@
 #include <cereal/types/string.hpp>
 #include <cereal/types/vector.hpp>
 #include <core/column_base_typed.hpp>
+#include <core/selection_kernels.hpp>
 #include <fstream>
 #include <iostream>
 #include <numeric>
@@ -64,8 +65,20 @@ namespace CoGaDB {
 
         T operator[](int index) final;
 
+        void decompress(TID begin, TID end, T *out) const final;
+
         [[maybe_unused]] std::vector<T> &getContent();
 
+    protected:
+        /*! \brief the returned scan compares the values with SIMD kernels specialized for the comparator*/
+        typename ColumnBaseTyped<T>::RangeSelection prepareSelection(const T &value, ValueComparator comp) final;
+
+        /*! \brief stores the comparison masks of the selection kernels directly as bitmap words*/
+        typename ColumnBaseTyped<T>::RangeBitmapSelection prepareBitmapSelection(const T &value, ValueComparator comp) final;
+
+        /*! \brief transforms the values in place*/
+        void applyScalar(ColumnAlgebraOperation op, const T &value) final;
+
     private:
         struct Type_TID_Comparator {
             inline bool operator()(std::pair<T, TID> i, std::pair<T, TID> j) {
@@ -177,6 +190,53 @@ namespace CoGaDB {
         return values_[index];
     }
 
+    template<class T>
+    void Column<T>::decompress(TID begin, TID end, T *out) const {
+        std::copy(values_.begin() + begin, values_.begin() + end, out);
+    }
+
+    template<class T>
+    typename ColumnBaseTyped<T>::RangeSelection Column<T>::prepareSelection(const T &value, const ValueComparator comp) {
+        return [this, value, comp](TID begin, TID end, PositionList &result_tids) {
+            // the kernels write into a buffer sized for the worst case, which is shrunk to the matches afterwards
+            size_t offset = result_tids.size();
+            result_tids.resize(offset + (end - begin));
+            size_t count = selectValues(values_.data(), begin, end, value, comp, result_tids.data() + offset);
+            result_tids.resize(offset + count);
+        };
+    }
+
+    template<class T>
+    typename ColumnBaseTyped<T>::RangeBitmapSelection Column<T>::prepareBitmapSelection(const T &value,
+                                                                                      const ValueComparator comp) {
+        return [this, value, comp](TID begin, TID end, Bitmap &result) {
+            selectBits(values_.data() + begin, end - begin, value, comp, result.data() + begin / 64);
+        };
+    }
+
+    template<class T>
+    void Column<T>::applyScalar(ColumnAlgebraOperation op, const T &value) {
+        if constexpr(std::is_arithmetic_v<T>) {
+            // one loop per operation, so the compiler can vectorize it
+            switch (op) {
+                case ADD:
+                    std::transform(values_.begin(), values_.end(), values_.begin(), [value](T val) { return val + value; });
+                    break;
+                case SUB:
+                    std::transform(values_.begin(), values_.end(), values_.begin(), [value](T val) { return val - value; });
+                    break;
+                case MUL:
+                    std::transform(values_.begin(), values_.end(), values_.begin(), [value](T val) { return val * value; });
+                    break;
+                case DIV:
+                    std::transform(values_.begin(), values_.end(), values_.begin(), [value](T val) { return val / value; });
+                    break;
+            }
+        } else {
+            ColumnBaseTyped<T>::applyScalar(op, value);
+        }
+    }
+
     template<class T>
     size_t Column<T>::getSizeInBytes() const noexcept {
         return values_.capacity() * sizeof(T);
@@ -185,8 +245,8 @@ namespace CoGaDB {
     // total template specialization
     template<>
     inline size_t Column<std::string>::getSizeInBytes() const noexcept {
-        return std::accumulate(values_.cbegin(), values_.cend(), 0,
-                               [](size_t acc, const std::string &val) { return acc + val.size(); });
+        return std::accumulate(values_.cbegin(), values_.cend(), values_.capacity() * sizeof(std::string),
+                               [](size_t acc, const std::string &val) { return acc + detail::heapBytes(val); });
     }
 
     template<typename T>
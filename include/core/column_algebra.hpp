@@ -0,0 +1,28 @@
+#pragma once
+
+#include <algorithm>
+#include <core/column.hpp>
+#include <string>
+#include <thread>
+
+namespace CoGaDB {
+
+    /*!
+     *  \brief computes left[i] op right[i] for every row i and returns the results as a new column
+     *  \details The inputs may use any encoding. They are decompressed chunk by chunk and combined by up to
+     *  number_of_threads threads, every finished morsel is bulk inserted in tid order into a column of type
+     *  ResultColumn<T>, e.g. computeColumn<DictionaryCompressedColumn>(a, b, ADD, "a_plus_b"). So only a few morsels
+     *  are ever held uncompressed. Throws std::invalid_argument if the inputs differ in size, T has no arithmetic or
+     *  an integer division has a divisor of 0.
+     */
+    template<template<class> class ResultColumn = Column, class T>
+    ResultColumn<T> computeColumn(const ColumnBaseTyped<T> &left, const ColumnBaseTyped<T> &right,
+                                  ColumnAlgebraOperation op, const std::string &result_name,
+                                  unsigned int number_of_threads = std::thread::hardware_concurrency()) {
+        ResultColumn<T> result(result_name);
+        left.compute(right, op, std::max(1u, number_of_threads),
+                     [&result](const T *values, size_t count) { result.insert(values, values + count); });
+        return result;
+    }
+
+} // namespace CoGaDB
@@ -2,14 +2,21 @@
 #pragma once
 
 #include <algorithm>
-#include <any>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
 #include <core/base_column.hpp>
+#include <core/parallel_sort.hpp>
+#include <core/radix_hash_join.hpp>
 #include <fstream>
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 
@@ -17,6 +24,66 @@
 /*! \brief The global namespace of the programming tasks, to avoid name clashes with other libraries.*/
 namespace CoGaDB {
 
+    namespace detail {
+        /*! \brief returns the number of bytes value occupies outside of its own object*/
+        template<class T>
+        size_t heapBytes(const T &value) {
+            if constexpr(std::is_same_v<T, std::string>)
+                return value.capacity() > std::string().capacity() ? value.capacity() + 1 : 0;
+            else
+                return 0;
+        }
+
+        /*! \brief approximate bytes of one entry of a node based hash or tree index, key and code plus node pointers*/
+        template<class T>
+        constexpr size_t index_entry_bytes = sizeof(T) + sizeof(uint32_t) + 3 * sizeof(void *);
+    } // namespace detail
+
+    /*! \brief returns left op right, throws for types without arithmetic*/
+    template<class T>
+    T applyOperation(ColumnAlgebraOperation op, const T &left, const T &right) {
+        if constexpr(std::is_arithmetic_v<T>) {
+            switch (op) {
+                case ADD:
+                    return left + right;
+                case SUB:
+                    return left - right;
+                case MUL:
+                    return left * right;
+                case DIV:
+                    return left / right;
+            }
+        }
+        throw std::invalid_argument("applyOperation(): arithmetic is undefined on this type");
+    }
+
+    /*! \brief computes out[i] = left[i] op right[i] for all i < count with one loop per operation, so the compiler can
+     * vectorize it, throws for types without arithmetic*/
+    template<class T>
+    void applyOperation(ColumnAlgebraOperation op, const T *left, const T *right, T *out, size_t count) {
+        if constexpr(std::is_arithmetic_v<T>) {
+            switch (op) {
+                case ADD:
+                    for (size_t i = 0; i < count; i++)
+                        out[i] = left[i] + right[i];
+                    return;
+                case SUB:
+                    for (size_t i = 0; i < count; i++)
+                        out[i] = left[i] - right[i];
+                    return;
+                case MUL:
+                    for (size_t i = 0; i < count; i++)
+                        out[i] = left[i] * right[i];
+                    return;
+                case DIV:
+                    for (size_t i = 0; i < count; i++)
+                        out[i] = left[i] / right[i];
+                    return;
+            }
+        }
+        throw std::invalid_argument("applyOperation(): arithmetic is undefined on this type");
+    }
+
     /*!
      *
      *
@@ -34,6 +101,27 @@ namespace CoGaDB {
     public:
         using value_type = T;
 
+        /*! \brief appends the tids of all rows in [begin, end) that satisfy a prepared filter condition to a
+         * PositionList*/
+        using RangeSelection = std::function<void(TID begin, TID end, PositionList &result_tids)>;
+
+        /*! \brief sets the bits of all rows in [begin, end) that satisfy a prepared filter condition in a Bitmap of the
+         * size of the column, whose bits in [begin, end) are not set yet. begin is a multiple of 64 and end is a
+         * multiple of 64 or the size of the column, so the words of a range can be written as a whole.*/
+        using RangeBitmapSelection = std::function<void(TID begin, TID end, Bitmap &result)>;
+
+        /*! \brief number of rows processed as one unit of work by parallel_selection*/
+        static constexpr TID MORSEL_SIZE = 16384;
+
+        /*! \brief number of rows the generic algorithms decompress at once*/
+        static constexpr TID DECOMPRESSION_CHUNK_SIZE = 4096;
+
+        /*! \brief minimum number of rows for sort to use more than one thread*/
+        static constexpr size_t PARALLEL_SORT_THRESHOLD = 1 << 16;
+
+        /*! \brief minimum number of rows of both join inputs for hash_join to join partitions in parallel*/
+        static constexpr size_t PARALLEL_JOIN_THRESHOLD = 1 << 16;
+
         /***************** constructors and destructor *****************/
         //inherit constructor
         using ColumnBase::ColumnBase;
@@ -53,6 +141,8 @@ namespace CoGaDB {
                                         ValueComparator comp,
                                         unsigned int number_of_threads) override;
 
+        Bitmap bitmap_selection(const ColumnType &value_for_comparison, ValueComparator comp) override;
+
         // join algorithms
         PositionListPair hash_join(ColumnBase &join_column) override;
 
@@ -83,40 +173,258 @@ namespace CoGaDB {
          * */
         virtual T operator[](int index) = 0;
 
+        /*! \brief decompresses the values of the rows in [begin, end) to out
+         * \details All generic algorithms access the column through this method. The default implementation uses
+         * operator[], so compressed columns should override it with a sequential decoder.*/
+        virtual void decompress(TID begin, TID end, T *out) const;
+
         inline bool operator==(const ColumnBaseTyped<T> &column) const;
 
+        /*! \brief computes this[i] op column[i] for every row i and passes the results morsel by morsel in tid order to
+         * consume(values, count)
+         * \details Both columns are decompressed chunk by chunk, the morsels of the columns are processed by up to
+         * number_of_threads threads. A finished morsel is passed on as soon as all morsels before it are, so at most a
+         * few morsels per thread are buffered. consume is called by one thread at a time and must not throw. Throws
+         * std::invalid_argument if the columns differ in size or an integer division has a divisor of 0, in which case
+         * consume may already have received some morsels.*/
+        template<class Consumer>
+        void compute(const ColumnBaseTyped<T> &column, ColumnAlgebraOperation op, unsigned int number_of_threads,
+                     Consumer consume) const;
+
 
         /*! \brief returns database type of column (as defined in "SQL" statement)*/
         [[nodiscard]] AttributeType getType() const final;
+
+    protected:
+        /*! \brief prepares the evaluation of a filter condition and returns a function evaluating it on a range of rows
+         * \details selection and parallel_selection are implemented on top of this method, so a column only has to
+         * override it to provide an encoding-specific scan. The preparation may modify the column, the returned
+         * function must not, because parallel_selection calls it concurrently for disjoint ranges.*/
+        virtual RangeSelection prepareSelection(const T &value, ValueComparator comp);
+
+        /*! \brief prepares the evaluation of a filter condition and returns a function setting the bits of the
+         * qualifying rows of a range
+         * \details bitmap_selection is implemented on top of this method. The default collects the tids of a chunk
+         * with prepareSelection and sets their bits, so columns that can produce bits without tids should override it.
+         * The returned function must not modify the column.*/
+        virtual RangeBitmapSelection prepareBitmapSelection(const T &value, ValueComparator comp);
+
+        /*! \brief returns all (value, tid) pairs of the column ordered by value and tid
+         * \details the sort is skipped if the column is already sorted*/
+        std::vector<std::pair<T, TID>> sortedValueTIDPairs();
+
+        /*! \brief returns the values of all rows in tid order*/
+        std::vector<T> materializeValues() const;
+
+        /*! \brief decompresses the rows in [begin, end) in chunks of DECOMPRESSION_CHUNK_SIZE values and calls
+         * function(chunk_begin, chunk, chunk_size) for every chunk*/
+        template<class Function>
+        void forEachChunk(TID begin, TID end, Function function) const;
+
+        /*! \brief replaces the content of the column by values*/
+        void replaceContent(const std::vector<T> &values);
+
+        /*! \brief replaces every value v of the column by v op value
+         * \details add, minus, multiply and division are implemented on top of this method, so an encoding only has
+         * to override it to compute in the compressed domain. The default rebuilds the column from its decompressed
+         * values.*/
+        virtual void applyScalar(ColumnAlgebraOperation op, const T &value);
+
+        /*! \brief replaces every value of the column by this[i] op column[i]
+         * \return false if column is not of type T, differs in size or is an integer divisor containing 0*/
+        bool applyColumn(ColumnAlgebraOperation op, ColumnBase &column);
     };
 
     template<class T>
-    PositionList ColumnBaseTyped<T>::sort(SortOrder order) {
-        PositionList ids;
-        std::vector<std::pair<T, TID>> v;
+    template<class Consumer>
+    void ColumnBaseTyped<T>::compute(const ColumnBaseTyped<T> &column, ColumnAlgebraOperation op,
+                                     unsigned int number_of_threads, Consumer consume) const {
+        if (column.size() != this->size())
+            throw std::invalid_argument("ColumnBaseTyped::compute(): columns " + this->name_ + " and " +
+                                        column.getName() + " differ in size");
+        // applyOperation would throw inside the workers
+        if constexpr(!std::is_arithmetic_v<T>)
+            throw std::invalid_argument("ColumnBaseTyped::compute(): arithmetic is undefined on column " + this->name_);
+
+        const size_t number_of_morsels = (this->size() + MORSEL_SIZE - 1) / MORSEL_SIZE;
+        const auto column_size = static_cast<TID>(this->size());
+        // a worker only starts a morsel that is at most window morsels ahead of the next one to pass on
+        const size_t window = 2 * std::max(1u, number_of_threads);
+        std::mutex mutex;
+        std::condition_variable passed_on;
+        // finished morsels waiting for their predecessors, a morsel is never empty
+        std::vector<std::vector<T>> finished(number_of_morsels);
+        size_t next_to_pass_on = 0;
+        bool division_by_zero = false;
+        std::atomic<size_t> next_morsel{0};
+        auto worker = [&]() {
+            std::vector<T> chunk(std::min<size_t>(DECOMPRESSION_CHUNK_SIZE, this->size()));
+            for (size_t morsel = next_morsel++; morsel < number_of_morsels; morsel = next_morsel++) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    passed_on.wait(lock, [&]() { return morsel < next_to_pass_on + window || division_by_zero; });
+                    if (division_by_zero)
+                        return;
+                }
 
-        for (unsigned int i = 0; i < this->size(); i++) {
-            v.push_back(std::pair<T, TID>((*this)[i], i));
+                // the morsel is decompressed into its result and combined in place with the chunks of column
+                const auto morsel_begin = static_cast<TID>(morsel * MORSEL_SIZE);
+                const TID morsel_end = std::min<TID>(morsel_begin + MORSEL_SIZE, column_size);
+                std::vector<T> values(morsel_end - morsel_begin);
+                for (TID begin = morsel_begin; begin < morsel_end; begin += DECOMPRESSION_CHUNK_SIZE) {
+                    TID end = std::min<TID>(begin + DECOMPRESSION_CHUNK_SIZE, morsel_end);
+                    T *out = values.data() + (begin - morsel_begin);
+                    this->decompress(begin, end, out);
+                    column.decompress(begin, end, chunk.data());
+                    if constexpr(std::is_integral_v<T>) {
+                        auto divisors_end = chunk.begin() + (end - begin);
+                        if (op == DIV && std::find(chunk.begin(), divisors_end, T(0)) != divisors_end) {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            division_by_zero = true;
+                            passed_on.notify_all();
+                            return;
+                        }
+                    }
+                    applyOperation(op, static_cast<const T *>(out), static_cast<const T *>(chunk.data()), out, end - begin);
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (division_by_zero)
+                    return;
+                finished[morsel] = std::move(values);
+                for (; next_to_pass_on < number_of_morsels && !finished[next_to_pass_on].empty(); next_to_pass_on++) {
+                    consume(static_cast<const T *>(finished[next_to_pass_on].data()), finished[next_to_pass_on].size());
+                    std::vector<T>().swap(finished[next_to_pass_on]);
+                }
+                passed_on.notify_all();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < std::min<size_t>(number_of_threads, number_of_morsels); i++)
+            threads.emplace_back(worker);
+        worker();
+        for (auto &thread: threads)
+            thread.join();
+
+        if (division_by_zero)
+            throw std::invalid_argument("ColumnBaseTyped::compute(): column " + column.getName() +
+                                        " contains a divisor of 0");
+    }
+
+    template<class T>
+    bool ColumnBaseTyped<T>::applyColumn(ColumnAlgebraOperation op, ColumnBase &column) {
+        auto *typed_column = dynamic_cast<ColumnBaseTyped<T> *>(&column);
+        if (typed_column == nullptr || typed_column->size() != this->size())
+            return false;
+
+        // the column is read while computing, so it is replaced only after all values are computed
+        std::vector<T> values;
+        values.reserve(this->size());
+        try {
+            compute(*typed_column, op, std::max(1u, std::thread::hardware_concurrency()),
+                    [&values](const T *morsel, size_t count) { values.insert(values.end(), morsel, morsel + count); });
+        } catch (const std::invalid_argument &) {
+            return false;
+        }
+        this->replaceContent(values);
+        return true;
+    }
+
+    template<class T>
+    void ColumnBaseTyped<T>::applyScalar(ColumnAlgebraOperation op, const T &value) {
+        std::vector<T> values = this->materializeValues();
+        for (auto &val: values)
+            val = applyOperation(op, val, value);
+        this->replaceContent(values);
+    }
+
+    template<class T>
+    void ColumnBaseTyped<T>::decompress(TID begin, TID end, T *out) const {
+        auto &column = const_cast<ColumnBaseTyped<T> &>(*this);
+        for (TID i = begin; i < end; i++)
+            *out++ = column[i];
+    }
+
+    template<class T>
+    std::vector<T> ColumnBaseTyped<T>::materializeValues() const {
+        std::vector<T> values(this->size());
+        decompress(0, static_cast<TID>(values.size()), values.data());
+        return values;
+    }
+
+    template<class T>
+    template<class Function>
+    void ColumnBaseTyped<T>::forEachChunk(TID begin, TID end, Function function) const {
+        std::vector<T> chunk(std::min<TID>(DECOMPRESSION_CHUNK_SIZE, end > begin ? end - begin : 0));
+        for (TID chunk_begin = begin; chunk_begin < end; chunk_begin += DECOMPRESSION_CHUNK_SIZE) {
+            TID chunk_size = std::min<TID>(DECOMPRESSION_CHUNK_SIZE, end - chunk_begin);
+            decompress(chunk_begin, chunk_begin + chunk_size, chunk.data());
+            function(chunk_begin, static_cast<const T *>(chunk.data()), chunk_size);
         }
+    }
 
-        if (order == ASCENDING) {
-            std::stable_sort(v.begin(), v.end(), std::less_equal<std::pair<T, TID>>());
-        } else if (order == DESCENDING) {
-            std::stable_sort(v.begin(), v.end(), std::greater_equal<std::pair<T, TID>>());
-        } else {
+    template<class T>
+    void ColumnBaseTyped<T>::replaceContent(const std::vector<T> &values) {
+        this->clearContent();
+        for (const T &value: values)
+            this->insert(value);
+    }
+
+    template<class T>
+    PositionList ColumnBaseTyped<T>::sort(SortOrder order) {
+        if (order != ASCENDING && order != DESCENDING) {
             std::cout << "FATAL ERROR: ColumnBaseTyped<T>::sort(): Unknown Sorting Order!" << std::endl;
+            return {};
         }
 
-        for (auto &elem: v)
-            ids.push_back(elem.second);
+        // small columns do not amortize the creation of threads
+        unsigned int number_of_threads = 1;
+        if (this->size() >= PARALLEL_SORT_THRESHOLD)
+            number_of_threads = std::max(1u, std::thread::hardware_concurrency());
 
-        return ids;
+        return parallelSort(this->materializeValues(), order, number_of_threads);
     }
 
     template<class T>
-    PositionList ColumnBaseTyped<T>::parallel_selection(const ColumnType &, const ValueComparator, unsigned int) {
-        PositionList result_tids;
+    PositionList ColumnBaseTyped<T>::parallel_selection(const ColumnType &value_for_comparison,
+                                                        const ValueComparator comp,
+                                                        unsigned int number_of_threads) {
+        const size_t number_of_morsels = (this->size() + MORSEL_SIZE - 1) / MORSEL_SIZE;
+        if (number_of_threads <= 1 || number_of_morsels <= 1)
+            return selection(value_for_comparison, comp);
 
+        if (!quiet)
+            std::cout << "Using " << number_of_threads << " CPU threads for Selection..." << std::endl;
+
+        RangeSelection scan = prepareSelection(std::get<T>(value_for_comparison), comp);
+
+        // workers fetch morsels until all are processed, every morsel has its own result
+        std::vector<PositionList> morsel_results(number_of_morsels);
+        std::atomic<size_t> next_morsel{0};
+        const auto column_size = static_cast<TID>(this->size());
+        auto worker = [&]() {
+            for (size_t morsel = next_morsel++; morsel < number_of_morsels; morsel = next_morsel++) {
+                TID begin = static_cast<TID>(morsel * MORSEL_SIZE);
+                scan(begin, std::min<TID>(begin + MORSEL_SIZE, column_size), morsel_results[morsel]);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < std::min<size_t>(number_of_threads, number_of_morsels); i++)
+            threads.emplace_back(worker);
+        worker();
+        for (auto &thread: threads)
+            thread.join();
+
+        // concatenate the partial results in tid order
+        size_t result_size = 0;
+        for (auto &morsel_result: morsel_results)
+            result_size += morsel_result.size();
+        PositionList result_tids;
+        result_tids.reserve(result_size);
+        for (auto &morsel_result: morsel_results)
+            result_tids.insert(result_tids.end(), morsel_result.begin(), morsel_result.end());
         return result_tids;
     }
 
@@ -128,37 +436,59 @@ namespace CoGaDB {
 
         if (!quiet)
             std::cout << "Using CPU for Selection..." << std::endl;
-        for (TID i = 0; i < this->size(); i++) {
-            // std::any value = column->get(i);
-            // val = values_[i];
-
-            if (comp == EQUAL) {
-                if (value == (*this)[i]) {
-                    // result_table->insert(this->fetchTuple(i));
-                    result_tids.push_back(i);
-                }
-            } else if (comp == LESSER) {
-                if ((*this)[i] < value) {
-                    // result_table->insert(this->fetchTuple(i));
-                    result_tids.push_back(i);
-                }
-            } else if (comp == GREATER) {
-                if ((*this)[i] > value) {
-                    result_tids.push_back(i);
-                    // result_table->insert(this->fetchTuple(i));
-                }
-            } else {
+        prepareSelection(value, comp)(0, static_cast<TID>(this->size()), result_tids);
+        return result_tids;
+    }
+
+    template<class T>
+    Bitmap ColumnBaseTyped<T>::bitmap_selection(const ColumnType &value_for_comparison, const ValueComparator comp) {
+        Bitmap result(this->size());
+        prepareBitmapSelection(std::get<T>(value_for_comparison), comp)(0, static_cast<TID>(this->size()), result);
+        return result;
+    }
+
+    template<class T>
+    typename ColumnBaseTyped<T>::RangeBitmapSelection ColumnBaseTyped<T>::prepareBitmapSelection(const T &value,
+                                                                                                  const ValueComparator comp) {
+        return [scan = prepareSelection(value, comp)](TID begin, TID end, Bitmap &result) {
+            // the tids of one chunk at a time are collected and turned into bits
+            PositionList chunk_tids;
+            chunk_tids.reserve(std::min<TID>(DECOMPRESSION_CHUNK_SIZE, end - begin));
+            for (TID chunk_begin = begin; chunk_begin < end; chunk_begin += DECOMPRESSION_CHUNK_SIZE) {
+                chunk_tids.clear();
+                scan(chunk_begin, std::min<TID>(chunk_begin + DECOMPRESSION_CHUNK_SIZE, end), chunk_tids);
+                for (TID tid: chunk_tids)
+                    result.set(static_cast<size_t>(tid));
             }
-        }
+        };
+    }
 
-        //}
-        return result_tids;
+    template<class T>
+    typename ColumnBaseTyped<T>::RangeSelection ColumnBaseTyped<T>::prepareSelection(const T &value,
+                                                                                      const ValueComparator comp) {
+        return [this, value, comp](TID begin, TID end, PositionList &result_tids) {
+            forEachChunk(begin, end, [&](TID chunk_begin, const T *chunk, TID chunk_size) {
+                for (TID i = 0; i < chunk_size; i++) {
+                    if (comp == EQUAL) {
+                        if (value == chunk[i]) {
+                            result_tids.push_back(chunk_begin + i);
+                        }
+                    } else if (comp == LESSER) {
+                        if (chunk[i] < value) {
+                            result_tids.push_back(chunk_begin + i);
+                        }
+                    } else if (comp == GREATER) {
+                        if (chunk[i] > value) {
+                            result_tids.push_back(chunk_begin + i);
+                        }
+                    }
+                }
+            });
+        };
     }
 
     template<class T>
     PositionListPair ColumnBaseTyped<T>::hash_join(ColumnBase &join_column_) {
-        typedef std::unordered_multimap<T, TID, std::hash<T>, std::equal_to<T>> HashTable;
-
         if (join_column_.getType() != getType()) {
             std::cerr << "Fatal Error!!! Type mismatch for columns " << this->name_ << " and " << join_column_.getName()
                       << std::endl;
@@ -166,29 +496,33 @@ namespace CoGaDB {
             std::abort();
         }
 
-        auto &join_column = reinterpret_cast<ColumnBaseTyped<T> &>(join_column_);
+        auto &join_column = dynamic_cast<ColumnBaseTyped<T> &>(join_column_);
 
-        PositionListPair join_tids;
+        // decode both inputs once, so the join does not call the virtual accessor per probe
+        std::vector<T> left = this->materializeValues();
+        std::vector<T> right = join_column.materializeValues();
 
-        // create hash table
-        HashTable hashtable;
-        for (unsigned int i = 0; i < this->size(); i++)
-            hashtable.insert(std::pair<T, TID>((*this)[i], i));
-
-        // probe larger relation
-        for (unsigned int i = 0; i < join_column.size(); i++) {
-            std::pair<typename HashTable::iterator, typename HashTable::iterator> range =
-                    hashtable.equal_range(join_column[i]);
-            for (typename HashTable::iterator it = range.first; it != range.second; it++) {
-                if (it->first == join_column[i]) {
-                    join_tids.first.push_back(it->second);
-                    join_tids.second.push_back(i);
-                    // cout << "match! " << it->second << ", " << i << "	"  << it->first << endl;
-                }
-            }
-        }
+        // small joins do not amortize the creation of threads
+        unsigned int number_of_threads = 1;
+        if (left.size() + right.size() >= PARALLEL_JOIN_THRESHOLD)
+            number_of_threads = std::max(1u, std::thread::hardware_concurrency());
 
-        return join_tids;
+        return detail::radixHashJoin(left, right, number_of_threads);
+    }
+
+    template<class T>
+    std::vector<std::pair<T, TID>> ColumnBaseTyped<T>::sortedValueTIDPairs() {
+        std::vector<T> values = this->materializeValues();
+        std::vector<std::pair<T, TID>> pairs;
+        pairs.reserve(values.size());
+        for (TID i = 0; i < values.size(); i++)
+            pairs.emplace_back(std::move(values[i]), i);
+
+        auto value_less = [](const std::pair<T, TID> &a, const std::pair<T, TID> &b) { return a.first < b.first; };
+        // the pairs are generated in tid order, so a stable sort keeps equal values ordered by tid
+        if (!std::is_sorted(pairs.begin(), pairs.end(), value_less))
+            std::stable_sort(pairs.begin(), pairs.end(), value_less);
+        return pairs;
     }
 
     template<class Type>
@@ -200,7 +534,39 @@ namespace CoGaDB {
             abort();
         }
 
+        auto &join_column = dynamic_cast<ColumnBaseTyped<Type> &>(join_column_);
+
+        std::vector<std::pair<Type, TID>> left = this->sortedValueTIDPairs();
+        std::vector<std::pair<Type, TID>> right = join_column.sortedValueTIDPairs();
+
         PositionListPair join_tids;
+
+        size_t i = 0, j = 0;
+        while (i < left.size() && j < right.size()) {
+            if (left[i].first < right[j].first) {
+                i++;
+            } else if (right[j].first < left[i].first) {
+                j++;
+            } else {
+                // emit the cross product of the runs of equal values on both sides
+                size_t left_end = i + 1;
+                while (left_end < left.size() && left[left_end].first == left[i].first)
+                    left_end++;
+                size_t right_end = j + 1;
+                while (right_end < right.size() && right[right_end].first == right[j].first)
+                    right_end++;
+
+                for (size_t l = i; l < left_end; l++) {
+                    for (size_t r = j; r < right_end; r++) {
+                        join_tids.first.push_back(left[l].second);
+                        join_tids.second.push_back(right[r].second);
+                    }
+                }
+                i = left_end;
+                j = right_end;
+            }
+        }
+
         return join_tids;
     }
 
@@ -213,21 +579,25 @@ namespace CoGaDB {
             exit(-1);
         }
 
-        auto &join_column =
-                reinterpret_cast<ColumnBaseTyped<Type> &>(join_column_); // static_cast<IntColumnPtr>(column1);
+        auto &join_column = dynamic_cast<ColumnBaseTyped<Type> &>(join_column_);
 
         PositionListPair join_tids;
 
-        for (unsigned int i = 0; i < this->size(); i++) {
-            for (unsigned int j = 0; j < join_column.size(); j++) {
-                if ((*this)[i] == join_column[j]) {
-                    if (debug)
-                        std::cout << "MATCH: (" << i << "," << j << ")" << std::endl;
-                    join_tids.first.push_back(i);
-                    join_tids.second.push_back(j);
+        // the inner relation is decompressed once, the outer one chunk by chunk
+        std::vector<Type> inner = join_column.materializeValues();
+        this->forEachChunk(0, static_cast<TID>(this->size()), [&](TID chunk_begin, const Type *chunk, TID chunk_size) {
+            for (TID k = 0; k < chunk_size; k++) {
+                TID i = chunk_begin + k;
+                for (TID j = 0; j < inner.size(); j++) {
+                    if (chunk[k] == inner[j]) {
+                        if (debug)
+                            std::cout << "MATCH: (" << i << "," << j << ")" << std::endl;
+                        join_tids.first.push_back(i);
+                        join_tids.second.push_back(j);
+                    }
                 }
             }
-        }
+        });
 
         return join_tids;
     }
@@ -236,12 +606,15 @@ namespace CoGaDB {
     bool ColumnBaseTyped<T>::operator==(const ColumnBaseTyped<T> &column) const {
         if (this->size() != column.size())
             return false;
-        for (unsigned int i = 0; i < this->size(); i++) {
-            if (const_cast<ColumnBaseTyped<T> &>(*this)[i] != const_cast<ColumnBaseTyped<T> &>(column)[i]) {
-                return false;
-            }
-        }
-        return true;
+        std::vector<T> other_chunk(std::min<size_t>(DECOMPRESSION_CHUNK_SIZE, column.size()));
+        bool equal = true;
+        this->forEachChunk(0, static_cast<TID>(this->size()), [&](TID chunk_begin, const T *chunk, TID chunk_size) {
+            if (!equal)
+                return;
+            column.decompress(chunk_begin, chunk_begin + chunk_size, other_chunk.data());
+            equal = std::equal(chunk, chunk + chunk_size, other_chunk.begin());
+        });
+        return equal;
     }
 
     template<class Type>
@@ -249,23 +622,13 @@ namespace CoGaDB {
         if (std::holds_alternative<std::monostate>(new_value))
             return false;
 
-        auto value = std::get<Type>(new_value);
-
-        for (unsigned int i = 0; i < this->size(); i++) {
-            this->update(i, this->operator[](i) + value);
-        }
+        this->applyScalar(ADD, std::get<Type>(new_value));
         return true;
     }
 
     template<class Type>
     bool ColumnBaseTyped<Type>::add(ColumnBase &column) {
-        // std::transform ( first, first+5, second, results, std::plus<int>() );
-        auto &typed_column = dynamic_cast<ColumnBaseTyped<Type> &>(column);
-
-        for (unsigned int i = 0; i < this->size(); i++) {
-            this->update(i, this->operator[](i) + typed_column[i]);
-        }
-        return true;
+        return this->applyColumn(ADD, column);
     }
 
     template<class Type>
@@ -275,22 +638,13 @@ namespace CoGaDB {
         if (std::holds_alternative<std::monostate>(new_value))
             return false;
 
-        auto value = std::get<Type>(new_value);
-        for (unsigned int i = 0; i < this->size(); i++) {
-            this->update(i, this->operator[](i) - value);
-        }
+        this->applyScalar(SUB, std::get<Type>(new_value));
         return true;
     }
 
     template<class Type>
     bool ColumnBaseTyped<Type>::minus(ColumnBase &column) {
-        // std::transform ( first, first+5, second, results, std::plus<int>() );
-        auto &typed_column = reinterpret_cast<ColumnBaseTyped<Type> &>(column);
-
-        for (unsigned int i = 0; i < this->size(); i++) {
-            this->update(i, this->operator[](i) - typed_column[i]);
-        }
-        return true;
+        return this->applyColumn(SUB, column);
     }
 
     template<class Type>
@@ -298,24 +652,13 @@ namespace CoGaDB {
         if (std::holds_alternative<std::monostate>(new_value))
             return false;
 
-        Type value = std::any_cast<Type>(new_value);
-        for (unsigned int i = 0; i < this->size(); i++) {
-            auto tmp = this->operator[](i) * value;
-            this->update(i, tmp);
-        }
+        this->applyScalar(MUL, std::get<Type>(new_value));
         return true;
     }
 
     template<class Type>
     bool ColumnBaseTyped<Type>::multiply(ColumnBase &column) {
-        // std::transform ( first, first+5, second, results, std::plus<int>() );
-        auto &typed_column = dynamic_cast<ColumnBaseTyped<Type> &>(column);
-
-        for (unsigned int i = 0; i < this->size(); i++) {
-            auto tmp = this->operator[](i) * typed_column[i];
-            this->update(i, tmp);
-        }
-        return true;
+        return this->applyColumn(MUL, column);
     }
 
     template<class Type>
@@ -323,27 +666,17 @@ namespace CoGaDB {
         if (std::holds_alternative<std::monostate>(new_value))
             return false;
 
-        Type value = std::any_cast<Type>(new_value);
+        Type value = std::get<Type>(new_value);
         // check that we do not divide by zero
         if (value == 0)
             return false;
-        for (unsigned int i = 0; i < this->size(); i++) {
-            auto val = this->operator[](i) / value;
-            this->update(i, val);
-        }
+        this->applyScalar(DIV, value);
         return true;
     }
 
     template<class Type>
     bool ColumnBaseTyped<Type>::division(ColumnBase &column) {
-        // std::transform ( first, first+5, second, results, std::plus<int>() );
-        auto &typed_column = reinterpret_cast<ColumnBaseTyped<Type> &>(column);
-
-        for (unsigned int i = 0; i < this->size(); i++) {
-            auto val = this->operator[](i) / typed_column[i];
-            this->update(i, val);
-        }
-        return true;
+        return this->applyColumn(DIV, column);
     }
 
     // total template specializations, because numeric computations are undefined on strings
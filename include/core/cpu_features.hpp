@@ -0,0 +1,21 @@
+#pragma once
+
+/*! \brief defined if x86-64 SIMD intrinsics (SSE2 as baseline, AVX2 via function target attributes) can be used*/
+#if defined(__GNUC__) && defined(__x86_64__)
+#define COGADB_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace CoGaDB {
+
+    /*! \brief returns true if the executing CPU supports AVX2, the check is performed once*/
+    inline bool cpuSupportsAVX2() noexcept {
+#ifdef COGADB_X86_SIMD
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+} // namespace CoGaDB
@@ -26,6 +26,14 @@ namespace CoGaDB
         EQUAL
     };
 
+    enum ColumnAlgebraOperation
+    {
+        ADD,
+        SUB,
+        MUL,
+        DIV
+    };
+
     enum SortOrder
     {
         ASCENDING,
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <core/base_column.hpp>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CoGaDB {
+
+    namespace detail {
+        /*! \brief calls function(0), ..., function(number_of_threads - 1) in parallel, the calling thread runs the first
+         * call*/
+        template<class Function>
+        void runParallel(unsigned int number_of_threads, Function function) {
+            std::vector<std::thread> threads;
+            for (unsigned int t = 1; t < number_of_threads; t++)
+                threads.emplace_back(function, t);
+            function(0u);
+            for (auto &thread: threads)
+                thread.join();
+        }
+
+        /*! \brief maps value to an unsigned key with the same order
+         * \details the sign bit of integers is flipped, negative floats are complemented and positive floats get their
+         * sign bit set. -0.0 is mapped to the key of 0.0, because both compare equal.*/
+        template<class T>
+        inline uint32_t radixKey(T value) {
+            if constexpr(std::is_same_v<T, float>) {
+                uint32_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                if (bits == 0x80000000u)
+                    bits = 0;
+                return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+            } else {
+                return static_cast<uint32_t>(value) ^ 0x80000000u;
+            }
+        }
+
+        /*! \brief sorts the tids of values ascending by (value, tid) with a parallel least significant digit radix sort
+         * \details Every pass splits the input into one contiguous block per thread. The threads count the digits of
+         * their block, the offsets of every (digit, block) pair follow from the counts in digit-major order, so the
+         * scatter is stable. Passes where all keys share the same digit are skipped.*/
+        template<class T>
+        PositionList radixSort(const std::vector<T> &values, unsigned int number_of_threads) {
+            constexpr unsigned int RADIX_BITS = 8;
+            constexpr size_t NUMBER_OF_BUCKETS = size_t(1) << RADIX_BITS;
+            using Histogram = std::array<size_t, NUMBER_OF_BUCKETS>;
+
+            const size_t size = values.size();
+            std::vector<uint32_t> keys(size), keys_buffer(size);
+            PositionList tids(size), tids_buffer(size);
+            const size_t block_size = (size + number_of_threads - 1) / number_of_threads;
+            std::vector<Histogram> histograms(number_of_threads);
+
+            runParallel(number_of_threads, [&](unsigned int t) {
+                for (size_t i = t * block_size; i < std::min(size, (t + 1) * block_size); i++) {
+                    keys[i] = radixKey(values[i]);
+                    tids[i] = static_cast<TID>(i);
+                }
+            });
+
+            for (unsigned int shift = 0; shift < 32; shift += RADIX_BITS) {
+                runParallel(number_of_threads, [&](unsigned int t) {
+                    Histogram &histogram = histograms[t];
+                    histogram.fill(0);
+                    for (size_t i = t * block_size; i < std::min(size, (t + 1) * block_size); i++)
+                        histogram[(keys[i] >> shift) & (NUMBER_OF_BUCKETS - 1)]++;
+                });
+
+                // turn the counts into write offsets: digit by digit, blocks in input order
+                size_t offset = 0;
+                bool single_digit = false;
+                for (size_t digit = 0; digit < NUMBER_OF_BUCKETS; digit++) {
+                    size_t digit_count = 0;
+                    for (unsigned int t = 0; t < number_of_threads; t++) {
+                        size_t count = histograms[t][digit];
+                        histograms[t][digit] = offset;
+                        offset += count;
+                        digit_count += count;
+                    }
+                    single_digit |= digit_count == size;
+                }
+                if (single_digit)
+                    continue;
+
+                runParallel(number_of_threads, [&](unsigned int t) {
+                    Histogram &write_positions = histograms[t];
+                    for (size_t i = t * block_size; i < std::min(size, (t + 1) * block_size); i++) {
+                        size_t position = write_positions[(keys[i] >> shift) & (NUMBER_OF_BUCKETS - 1)]++;
+                        keys_buffer[position] = keys[i];
+                        tids_buffer[position] = tids[i];
+                    }
+                });
+                keys.swap(keys_buffer);
+                tids.swap(tids_buffer);
+            }
+            return tids;
+        }
+
+        /*! \brief sorts the tids of values ascending by (value, tid) with a parallel merge sort
+         * \details every thread stable sorts one block, neighbouring blocks are merged pairwise in parallel rounds*/
+        template<class T>
+        PositionList mergeSort(std::vector<T> values, unsigned int number_of_threads) {
+            std::vector<std::pair<T, TID>> pairs;
+            pairs.reserve(values.size());
+            for (TID i = 0; i < values.size(); i++)
+                pairs.emplace_back(std::move(values[i]), i);
+
+            // the pairs are generated in tid order, so stable sorting and merging by value keeps equal values ordered by tid
+            auto value_less = [](const std::pair<T, TID> &a, const std::pair<T, TID> &b) { return a.first < b.first; };
+            const size_t size = pairs.size();
+            std::vector<size_t> bounds(number_of_threads + 1);
+            for (unsigned int t = 0; t <= number_of_threads; t++)
+                bounds[t] = size * t / number_of_threads;
+
+            runParallel(number_of_threads, [&](unsigned int t) {
+                std::stable_sort(pairs.begin() + bounds[t], pairs.begin() + bounds[t + 1], value_less);
+            });
+            for (size_t width = 1; width < number_of_threads; width *= 2) {
+                auto merges = static_cast<unsigned int>((number_of_threads + 2 * width - 1) / (2 * width));
+                runParallel(merges, [&](unsigned int m) {
+                    size_t first = 2 * width * m;
+                    size_t middle = std::min<size_t>(first + width, number_of_threads);
+                    size_t last = std::min<size_t>(first + 2 * width, number_of_threads);
+                    std::inplace_merge(pairs.begin() + bounds[first], pairs.begin() + bounds[middle],
+                                       pairs.begin() + bounds[last], value_less);
+                });
+            }
+
+            PositionList tids;
+            tids.reserve(size);
+            for (auto &pair: pairs)
+                tids.push_back(pair.second);
+            return tids;
+        }
+    } // namespace detail
+
+    /*!
+     *  \brief returns the tids of values ordered by (value, tid), DESCENDING is the exact reverse of ASCENDING
+     *  \details int and float values are sorted with a parallel radix sort on order-preserving keys, all other types
+     *  with a parallel merge sort. Both use up to number_of_threads threads.
+     */
+    template<class T>
+    PositionList parallelSort(std::vector<T> values, SortOrder order, unsigned int number_of_threads) {
+        number_of_threads = static_cast<unsigned int>(
+                std::max<size_t>(1, std::min<size_t>(number_of_threads, values.size())));
+
+        PositionList tids;
+        if constexpr(std::is_same_v<T, int> || std::is_same_v<T, float>)
+            tids = detail::radixSort(values, number_of_threads);
+        else
+            tids = detail::mergeSort(std::move(values), number_of_threads);
+
+        if (order == DESCENDING)
+            std::reverse(tids.begin(), tids.end());
+        return tids;
+    }
+
+} // namespace CoGaDB
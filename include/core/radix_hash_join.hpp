@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <core/base_column.hpp>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace CoGaDB {
+
+    namespace detail {
+
+        /*! \brief a tuple of a join input after partitioning: the hash of its value and its tid*/
+        struct HashedTID {
+            uint32_t hash;
+            TID tid;
+        };
+
+        /*! \brief mixes the bits of a std::hash value, because std::hash is the identity for integers*/
+        inline uint32_t mixHash(size_t hash) {
+            uint64_t h = hash;
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return static_cast<uint32_t>(h);
+        }
+
+        /*! \brief scatters the tuples of values into 2^radix_bits partitions using the lowest bits of their hashes
+         * \details partition p consists of the tuples in [offsets[p], offsets[p + 1])*/
+        template<class T>
+        std::vector<HashedTID> radixPartition(const std::vector<T> &values, unsigned int radix_bits,
+                                              std::vector<size_t> &offsets) {
+            const size_t number_of_partitions = size_t(1) << radix_bits;
+            const uint32_t mask = static_cast<uint32_t>(number_of_partitions - 1);
+
+            std::vector<uint32_t> hashes(values.size());
+            offsets.assign(number_of_partitions + 1, 0);
+            for (size_t i = 0; i < values.size(); i++) {
+                hashes[i] = mixHash(std::hash<T>()(values[i]));
+                offsets[(hashes[i] & mask) + 1]++;
+            }
+            for (size_t p = 0; p < number_of_partitions; p++)
+                offsets[p + 1] += offsets[p];
+
+            std::vector<size_t> write_positions(offsets.begin(), offsets.end() - 1);
+            std::vector<HashedTID> partitioned(values.size());
+            for (size_t i = 0; i < values.size(); i++)
+                partitioned[write_positions[hashes[i] & mask]++] = HashedTID{hashes[i], static_cast<TID>(i)};
+            return partitioned;
+        }
+
+        /*! \brief joins one pair of partitions with an open addressing hash table built on the build partition*/
+        template<class T>
+        void joinPartition(const std::vector<T> &build_values, const HashedTID *build, size_t build_size,
+                           const std::vector<T> &probe_values, const HashedTID *probe, size_t probe_size,
+                           unsigned int radix_bits, bool build_is_left, PositionListPair &result) {
+            if (build_size == 0 || probe_size == 0)
+                return;
+
+            size_t capacity = 1;
+            while (capacity < 2 * build_size)
+                capacity <<= 1;
+            const size_t slot_mask = capacity - 1;
+
+            // slots store 1 + the index of a build tuple, 0 marks an empty slot
+            std::vector<uint32_t> slots(capacity, 0);
+            for (size_t i = 0; i < build_size; i++) {
+                size_t slot = (build[i].hash >> radix_bits) & slot_mask;
+                while (slots[slot] != 0)
+                    slot = (slot + 1) & slot_mask;
+                slots[slot] = static_cast<uint32_t>(i + 1);
+            }
+
+            for (size_t i = 0; i < probe_size; i++) {
+                const T &value = probe_values[probe[i].tid];
+                for (size_t slot = (probe[i].hash >> radix_bits) & slot_mask; slots[slot] != 0;
+                     slot = (slot + 1) & slot_mask) {
+                    const HashedTID &candidate = build[slots[slot] - 1];
+                    if (candidate.hash == probe[i].hash && build_values[candidate.tid] == value) {
+                        result.first.push_back(build_is_left ? candidate.tid : probe[i].tid);
+                        result.second.push_back(build_is_left ? probe[i].tid : candidate.tid);
+                    }
+                }
+            }
+        }
+
+        /*! \brief equi-joins two value vectors with a radix partitioned hash join
+         * \details Both inputs are partitioned on their hash values, so the hash table of every partition fits into
+         * the cache. The table is built on the smaller input. Partitions are joined by up to number_of_threads
+         * threads. The first position list of the result refers to left, the second to right.*/
+        template<class T>
+        PositionListPair radixHashJoin(const std::vector<T> &left, const std::vector<T> &right,
+                                       unsigned int number_of_threads) {
+            constexpr size_t CACHE_SIZE = 256 * 1024;
+            constexpr unsigned int MAX_RADIX_BITS = 12;
+
+            const bool build_is_left = left.size() <= right.size();
+            const std::vector<T> &build_values = build_is_left ? left : right;
+            const std::vector<T> &probe_values = build_is_left ? right : left;
+
+            // choose the number of partitions such that a partition's hash table fits into the cache
+            const size_t table_bytes = 2 * build_values.size() * (sizeof(uint32_t) + sizeof(HashedTID));
+            unsigned int radix_bits = 0;
+            while (radix_bits < MAX_RADIX_BITS && (table_bytes >> radix_bits) > CACHE_SIZE)
+                radix_bits++;
+
+            std::vector<size_t> build_offsets, probe_offsets;
+            std::vector<HashedTID> build = radixPartition(build_values, radix_bits, build_offsets);
+            std::vector<HashedTID> probe = radixPartition(probe_values, radix_bits, probe_offsets);
+
+            const size_t number_of_partitions = size_t(1) << radix_bits;
+            std::vector<PositionListPair> partition_results(number_of_partitions);
+            std::atomic<size_t> next_partition{0};
+            auto worker = [&]() {
+                for (size_t p = next_partition++; p < number_of_partitions; p = next_partition++) {
+                    joinPartition(build_values, build.data() + build_offsets[p], build_offsets[p + 1] - build_offsets[p],
+                                  probe_values, probe.data() + probe_offsets[p], probe_offsets[p + 1] - probe_offsets[p],
+                                  radix_bits, build_is_left, partition_results[p]);
+                }
+            };
+
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < std::min<size_t>(number_of_threads, number_of_partitions); i++)
+                threads.emplace_back(worker);
+            worker();
+            for (auto &thread: threads)
+                thread.join();
+
+            if (number_of_partitions == 1)
+                return std::move(partition_results.front());
+
+            PositionListPair join_tids;
+            size_t result_size = 0;
+            for (auto &partition_result: partition_results)
+                result_size += partition_result.first.size();
+            join_tids.first.reserve(result_size);
+            join_tids.second.reserve(result_size);
+            for (auto &partition_result: partition_results) {
+                join_tids.first.insert(join_tids.first.end(), partition_result.first.begin(), partition_result.first.end());
+                join_tids.second.insert(join_tids.second.end(), partition_result.second.begin(), partition_result.second.end());
+            }
+            return join_tids;
+        }
+
+    } // namespace detail
+
+} // namespace CoGaDB
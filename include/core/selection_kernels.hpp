@@ -0,0 +1,238 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <core/cpu_features.hpp>
+#include <core/global_definitions.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace CoGaDB {
+
+    namespace detail {
+        template<ValueComparator comp, class T>
+        inline bool qualifies(const T &row_value, const T &value) {
+            if constexpr(comp == EQUAL)
+                return row_value == value;
+            else if constexpr(comp == LESSER)
+                return row_value < value;
+            else
+                return row_value > value;
+        }
+
+        /*! \brief writes the tid of every row unconditionally and advances the output only for qualifying rows, so
+         * the loop does not contain a data dependent branch*/
+        template<ValueComparator comp, class T>
+        inline size_t selectScalar(const T *values, TID begin, TID end, const T &value, TID *out) {
+            size_t count = 0;
+            for (TID i = begin; i < end; i++) {
+                out[count] = i;
+                count += qualifies<comp>(values[i], value);
+            }
+            return count;
+        }
+
+#ifdef COGADB_X86_SIMD
+        /*! \brief permutations moving the lanes selected by an 8 bit mask to the front of a 256 bit register*/
+        inline const std::array<std::array<uint32_t, 8>, 256> &compressPermutations() {
+            static const std::array<std::array<uint32_t, 8>, 256> permutations = [] {
+                std::array<std::array<uint32_t, 8>, 256> table{};
+                for (uint32_t mask = 0; mask < 256; mask++) {
+                    uint32_t count = 0;
+                    for (uint32_t lane = 0; lane < 8; lane++) {
+                        if (mask & (1u << lane))
+                            table[mask][count++] = lane;
+                    }
+                }
+                return table;
+            }();
+            return permutations;
+        }
+
+        template<ValueComparator comp, class T>
+        inline int compareMaskSSE2(const T *values, const T &value) {
+            if constexpr(std::is_same_v<T, float>) {
+                __m128 x = _mm_loadu_ps(values);
+                __m128 v = _mm_set1_ps(value);
+                if constexpr(comp == EQUAL)
+                    return _mm_movemask_ps(_mm_cmpeq_ps(x, v));
+                else if constexpr(comp == LESSER)
+                    return _mm_movemask_ps(_mm_cmplt_ps(x, v));
+                else
+                    return _mm_movemask_ps(_mm_cmpgt_ps(x, v));
+            } else {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+                __m128i v = _mm_set1_epi32(value);
+                __m128i result;
+                if constexpr(comp == EQUAL)
+                    result = _mm_cmpeq_epi32(x, v);
+                else if constexpr(comp == LESSER)
+                    result = _mm_cmplt_epi32(x, v);
+                else
+                    result = _mm_cmpgt_epi32(x, v);
+                return _mm_movemask_ps(_mm_castsi128_ps(result));
+            }
+        }
+
+        template<ValueComparator comp, class T>
+        inline size_t selectSSE2(const T *values, TID begin, TID end, const T &value, TID *out) {
+            size_t count = 0;
+            TID i = begin;
+            for (; i + 4 <= end; i += 4) {
+                auto mask = static_cast<unsigned int>(compareMaskSSE2<comp>(values + i, value));
+                while (mask != 0) {
+                    out[count++] = i + __builtin_ctz(mask);
+                    mask &= mask - 1;
+                }
+            }
+            return count + selectScalar<comp>(values, i, end, value, out + count);
+        }
+
+        template<ValueComparator comp, class T>
+        __attribute__((target("avx2")))
+        inline int compareMaskAVX2(const T *values, const T &value) {
+            if constexpr(std::is_same_v<T, float>) {
+                __m256 x = _mm256_loadu_ps(values);
+                __m256 v = _mm256_set1_ps(value);
+                if constexpr(comp == EQUAL)
+                    return _mm256_movemask_ps(_mm256_cmp_ps(x, v, _CMP_EQ_OQ));
+                else if constexpr(comp == LESSER)
+                    return _mm256_movemask_ps(_mm256_cmp_ps(x, v, _CMP_LT_OQ));
+                else
+                    return _mm256_movemask_ps(_mm256_cmp_ps(x, v, _CMP_GT_OQ));
+            } else {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+                __m256i v = _mm256_set1_epi32(value);
+                __m256i result;
+                if constexpr(comp == EQUAL)
+                    result = _mm256_cmpeq_epi32(x, v);
+                else if constexpr(comp == LESSER)
+                    result = _mm256_cmpgt_epi32(v, x);
+                else
+                    result = _mm256_cmpgt_epi32(x, v);
+                return _mm256_movemask_ps(_mm256_castsi256_ps(result));
+            }
+        }
+
+        /*! \brief compares 8 values at once and stores the tids of the qualifying lanes with a permutation looked up
+         * by the comparison mask
+         * \details every store writes 8 tids, but never behind position end - begin of out*/
+        template<ValueComparator comp, class T>
+        __attribute__((target("avx2")))
+        inline size_t selectAVX2(const T *values, TID begin, TID end, const T &value, TID *out) {
+            const auto &permutations = compressPermutations();
+            size_t count = 0;
+            TID i = begin;
+            __m256i tids = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(begin)),
+                                            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+            const __m256i step = _mm256_set1_epi32(8);
+            for (; i + 8 <= end; i += 8) {
+                int mask = compareMaskAVX2<comp>(values + i, value);
+                __m256i permutation = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(permutations[mask].data()));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + count), _mm256_permutevar8x32_epi32(tids, permutation));
+                count += __builtin_popcount(static_cast<unsigned int>(mask));
+                tids = _mm256_add_epi32(tids, step);
+            }
+            return count + selectScalar<comp>(values, i, end, value, out + count);
+        }
+#endif
+
+        template<ValueComparator comp, class T>
+        inline size_t selectValues(const T *values, TID begin, TID end, const T &value, TID *out) {
+#ifdef COGADB_X86_SIMD
+            if constexpr(std::is_same_v<T, int> || std::is_same_v<T, float>) {
+                if (cpuSupportsAVX2())
+                    return selectAVX2<comp>(values, begin, end, value, out);
+                return selectSSE2<comp>(values, begin, end, value, out);
+            }
+#endif
+            return selectScalar<comp>(values, begin, end, value, out);
+        }
+
+        template<ValueComparator comp, class T>
+        inline void selectBitsScalar(const T *values, size_t count, const T &value, uint64_t *words) {
+            for (size_t w = 0; w * 64 < count; w++) {
+                uint64_t word = 0;
+                for (size_t i = w * 64; i < std::min(count, w * 64 + 64); i++)
+                    word |= uint64_t(qualifies<comp>(values[i], value)) << (i % 64);
+                words[w] = word;
+            }
+        }
+
+#ifdef COGADB_X86_SIMD
+        /*! \brief concatenates the comparison masks of 16 groups of 4 values to a word*/
+        template<ValueComparator comp, class T>
+        inline void selectBitsSSE2(const T *values, size_t count, const T &value, uint64_t *words) {
+            size_t w = 0;
+            for (; w * 64 + 64 <= count; w++) {
+                uint64_t word = 0;
+                for (size_t j = 0; j < 16; j++)
+                    word |= uint64_t(compareMaskSSE2<comp>(values + w * 64 + 4 * j, value)) << (4 * j);
+                words[w] = word;
+            }
+            selectBitsScalar<comp>(values + w * 64, count - w * 64, value, words + w);
+        }
+
+        /*! \brief concatenates the comparison masks of 8 groups of 8 values to a word*/
+        template<ValueComparator comp, class T>
+        __attribute__((target("avx2")))
+        inline void selectBitsAVX2(const T *values, size_t count, const T &value, uint64_t *words) {
+            size_t w = 0;
+            for (; w * 64 + 64 <= count; w++) {
+                uint64_t word = 0;
+                for (size_t j = 0; j < 8; j++)
+                    word |= uint64_t(static_cast<uint8_t>(compareMaskAVX2<comp>(values + w * 64 + 8 * j, value))) << (8 * j);
+                words[w] = word;
+            }
+            selectBitsScalar<comp>(values + w * 64, count - w * 64, value, words + w);
+        }
+#endif
+
+        template<ValueComparator comp, class T>
+        inline void selectBits(const T *values, size_t count, const T &value, uint64_t *words) {
+#ifdef COGADB_X86_SIMD
+            if constexpr(std::is_same_v<T, int> || std::is_same_v<T, float>) {
+                if (cpuSupportsAVX2())
+                    return selectBitsAVX2<comp>(values, count, value, words);
+                return selectBitsSSE2<comp>(values, count, value, words);
+            }
+#endif
+            selectBitsScalar<comp>(values, count, value, words);
+        }
+    } // namespace detail
+
+    /*! \brief writes the tids of all rows in [begin, end) of values satisfying the predicate to out and returns their
+     * number
+     * \details out has to provide space for end - begin tids. int and float values are compared with AVX2 or SSE2,
+     * depending on the executing CPU, all other types with a branch-free scalar loop.*/
+    template<class T>
+    inline size_t selectValues(const T *values, TID begin, TID end, const T &value, ValueComparator comp, TID *out) {
+        switch (comp) {
+            case EQUAL:
+                return detail::selectValues<EQUAL>(values, begin, end, value, out);
+            case LESSER:
+                return detail::selectValues<LESSER>(values, begin, end, value, out);
+            case GREATER:
+                return detail::selectValues<GREATER>(values, begin, end, value, out);
+        }
+        return 0;
+    }
+
+    /*! \brief sets bit i of words if values[i] satisfies the predicate and clears it otherwise, for all i < count
+     * \details all (count + 63) / 64 words are overwritten, the bits behind count are cleared. int and float values
+     * are compared with AVX2 or SSE2 like in selectValues, but the comparison masks are stored as they are instead of
+     * being turned into tids.*/
+    template<class T>
+    inline void selectBits(const T *values, size_t count, const T &value, ValueComparator comp, uint64_t *words) {
+        switch (comp) {
+            case EQUAL:
+                return detail::selectBits<EQUAL>(values, count, value, words);
+            case LESSER:
+                return detail::selectBits<LESSER>(values, count, value, words);
+            case GREATER:
+                return detail::selectBits<GREATER>(values, count, value, words);
+        }
+    }
+
+} // namespace CoGaDB
@@ -1,5 +1,7 @@
 #include <core/base_column.hpp>
-#include <utility>  // for move
+#include <core/column.hpp>  // for Column
+#include <stdexcept>        // for invalid_argument
+#include <utility>          // for move
 
 namespace CoGaDB
 {
@@ -12,4 +14,21 @@ namespace CoGaDB
     {
         return name_;
     }
+
+    std::unique_ptr<ColumnBase> createColumn(AttributeType type, const std::string &name)
+    {
+        switch (type)
+        {
+            case AttributeType::INT:
+                return std::make_unique<Column<int>>(name);
+            case AttributeType::FLOAT:
+                return std::make_unique<Column<float>>(name);
+            case AttributeType::VARCHAR:
+                return std::make_unique<Column<std::string>>(name);
+            case AttributeType::BOOLEAN:
+                break;
+        }
+        throw std::invalid_argument("createColumn(): unsupported attribute type " +
+                                    std::to_string(static_cast<int>(type)));
+    }
 } // namespace CoGaDB
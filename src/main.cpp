@@ -1,18 +1,31 @@
 #include "config.hpp"                           // for DATA_PATH
 #include "core/column.hpp"                      // for Column
+#include "core/column_algebra.hpp"              // for computeColumn
 #include "core/global_definitions.hpp"          // for CoGaDB, TID
 #include "tests/utils.hpp"                      // for isEqual, gen, getAt...
 #include <catch2/catch_template_test_macros.hpp>// for TEMPLATE_PRODUCT_TE...
 #include <catch2/catch_test_macros.hpp>         // for operator""_catch_sr
 #include <catch2/matchers/catch_matchers.hpp>   // for REQUIRE_THAT
+#include <cmath>                                // for isinf
+#include <cstring>                              // for memcmp
+#include <functional>                           // for function
+#include <iterator>                             // for istream_iterator
+#include <limits>                               // for numeric_limits
 #include <memory>                               // for unique_ptr
 #include <random>                               // for uniform_int_distrib...
+#include <sstream>                              // for istringstream
 #include <string>                               // for string
 #include <vector>                               // for vector
 
 #include "../include/compression/delta_encoded_column.hpp"
 #include "../include/compression/run_length_compressed_column.hpp"
 #include "../include/compression/dictionary_compressed_column.hpp"
+#include "../include/compression/frequency_partitioned_column.hpp"
+#include "../include/compression/bit_vector_encoded_column.hpp"
+#include "../include/compression/frame_of_reference_column.hpp"
+#include "../include/compression/xor_compressed_column.hpp"
+#include "../include/compression/front_coded_dictionary_column.hpp"
+#include "../include/compression/column_factory.hpp"
 
 namespace CoGaDB {
     class ColumnBase;
@@ -35,7 +48,7 @@ using namespace CoGaDB;
 TEMPLATE_PRODUCT_TEST_CASE_METHOD(Column_Test_Fixture,
                                   "Template test case method with test types specified inside std::tuple",
                                   "[class][template]",
-                                  (DeltaEncodedColumn /*TODO: insert your column types here, separated by comma*/),
+                                  (DeltaEncodedColumn, DictionaryCompressedColumn, RunLengthCompressedColumn, FrequencyPartitionedColumn, BitVectorEncodedColumn, FrameOfReferenceColumn, XorCompressedColumn /*TODO: insert your column types here, separated by comma*/),
                                   (int, float)) {
 
     using ValueType = typename Column_Test_Fixture<TestType>::ValueType;
@@ -54,6 +67,17 @@ TEMPLATE_PRODUCT_TEST_CASE_METHOD(Column_Test_Fixture,
 
     std::cout << " ----- Insert tests done ----- " << std::endl;
 
+    std::cout << " ----- Running range insert tests ----- " << std::endl;
+
+    /****** RANGE INSERT TEST ******/
+    TestType col_range(getAttributeString<ValueType>());
+    auto half = reference_data.begin() + reference_data.size() / 2;
+    REQUIRE_NOTHROW(col_range.insert(reference_data.begin(), half));
+    REQUIRE_NOTHROW(col_range.insert(half, reference_data.end()));
+    REQUIRE_THAT(col_range, isEqual<TestType>(reference_data));
+
+    std::cout << " ----- Range insert tests done ----- " << std::endl;
+
     std::cout << " ----- Running virtual copy constructor tests ----- " << std::endl;
 
     /****** VIRTUAL COPY CONSTRUCTOR TEST ******/
@@ -92,6 +116,94 @@ TEMPLATE_PRODUCT_TEST_CASE_METHOD(Column_Test_Fixture,
 
     std::cout << " ----- Delete tests done ----- " << std::endl;
 
+    std::cout << " ----- Running selection tests ----- " << std::endl;
+
+    /****** SELECTION TEST ******/
+    ValueType comparison_value = reference_data[reference_data.size() / 2];
+    for (ValueComparator comp: {EQUAL, LESSER, GREATER}) {
+        PositionList expected;
+        for (TID i = 0; i < reference_data.size(); i++) {
+            if ((comp == EQUAL && reference_data[i] == comparison_value) ||
+                (comp == LESSER && reference_data[i] < comparison_value) ||
+                (comp == GREATER && reference_data[i] > comparison_value))
+                expected.push_back(i);
+        }
+        REQUIRE(col_one.selection(comparison_value, comp) == expected);
+        REQUIRE(col_one.parallel_selection(comparison_value, comp, 4) == expected);
+        Bitmap bitmap = col_one.bitmap_selection(comparison_value, comp);
+        REQUIRE(bitmap == Bitmap::fromPositionList(expected, reference_data.size()));
+        REQUIRE(bitmap.toPositionList() == expected);
+    }
+    Bitmap lesser = col_one.bitmap_selection(comparison_value, LESSER);
+    Bitmap greater = col_one.bitmap_selection(comparison_value, GREATER);
+    REQUIRE((lesser & greater).count() == 0);
+    REQUIRE((lesser | greater).andNot(greater) == lesser);
+
+    std::cout << " ----- Selection tests done ----- " << std::endl;
+
+    std::cout << " ----- Running sort tests ----- " << std::endl;
+
+    /****** SORT TEST ******/
+    std::vector<std::pair<ValueType, TID>> value_tid_pairs;
+    for (TID i = 0; i < reference_data.size(); i++)
+        value_tid_pairs.emplace_back(reference_data[i], i);
+    std::sort(value_tid_pairs.begin(), value_tid_pairs.end());
+    PositionList expected_order;
+    for (auto &pair: value_tid_pairs)
+        expected_order.push_back(pair.second);
+    REQUIRE(col_one.sort(ASCENDING) == expected_order);
+    std::reverse(expected_order.begin(), expected_order.end());
+    REQUIRE(col_one.sort(DESCENDING) == expected_order);
+
+    std::cout << " ----- Sort tests done ----- " << std::endl;
+
+    std::cout << " ----- Running join tests ----- " << std::endl;
+
+    /****** JOIN TEST ******/
+    TestType col_join(getAttributeString<ValueType>());
+    col_join.insert(reference_data.begin(), reference_data.begin() + reference_data.size() / 4);
+    col_join.insert(reference_data.begin(), reference_data.begin() + reference_data.size() / 4);
+
+    auto sorted_pairs = [](const PositionListPair &join_tids) {
+        std::vector<std::pair<TID, TID>> pairs;
+        for (size_t i = 0; i < join_tids.first.size(); i++)
+            pairs.emplace_back(join_tids.first[i], join_tids.second[i]);
+        std::sort(pairs.begin(), pairs.end());
+        return pairs;
+    };
+    auto expected_pairs = sorted_pairs(col_one.nested_loop_join(col_join));
+    REQUIRE(!expected_pairs.empty());
+    REQUIRE(sorted_pairs(col_one.hash_join(col_join)) == expected_pairs);
+    REQUIRE(sorted_pairs(col_one.sort_merge_join(col_join)) == expected_pairs);
+
+    std::cout << " ----- Join tests done ----- " << std::endl;
+
+    std::cout << " ----- Running arithmetic tests ----- " << std::endl;
+
+    /****** ARITHMETIC TEST ******/
+    TestType col_arith(getAttributeString<ValueType>());
+    col_arith.insert(reference_data.begin(), reference_data.end());
+    std::vector<ValueType> expected_values(reference_data);
+    for (auto &value: expected_values)
+        value = (value * ValueType(2) + ValueType(3)) / ValueType(2);
+    REQUIRE(col_arith.multiply(ValueType(2)));
+    REQUIRE(col_arith.add(ValueType(3)));
+    REQUIRE(col_arith.division(ValueType(2)));
+    REQUIRE_FALSE(col_arith.division(ValueType(0)));
+    REQUIRE_THAT(col_arith, isEqual<TestType>(expected_values));
+
+    Column<ValueType> col_plain("plain");
+    col_plain.insert(expected_values.begin(), expected_values.end());
+    for (auto &value: expected_values)
+        value = value + value;
+    REQUIRE_THAT(computeColumn(col_arith, col_plain, ADD, "sum"), isEqual<Column<ValueType>>(expected_values));
+    REQUIRE(col_arith.add(col_plain));
+    REQUIRE_THAT(col_arith, isEqual<TestType>(expected_values));
+    col_plain.remove(0);
+    REQUIRE_FALSE(col_arith.minus(col_plain));
+
+    std::cout << " ----- Arithmetic tests done ----- " << std::endl;
+
     std::cout << " ----- Running store and load tests ----- " << std::endl;
 
 
@@ -108,3 +220,777 @@ TEMPLATE_PRODUCT_TEST_CASE_METHOD(Column_Test_Fixture,
     std::cout << " ----- Store and load tests done ----- " << std::endl;
     
 }
+
+TEST_CASE("XOR compressed column on slowly changing values", "[class][xor]") {
+    std::cout << " ----- Running XOR compression ratio tests ----- " << std::endl;
+
+    // a sensor reading with one decimal, which either repeats or moves by 0.1; one decimal values have noisy
+    // mantissas, so XOR alone only reaches 1.3x without repetitions, the decimal encoding reaches about 5.5x
+    for (int repeat_percentage: {0, 50, 75}) {
+        std::mt19937 walk(1);
+        std::uniform_int_distribution percent(0, 99), direction(0, 1);
+        std::vector<float> reference_data;
+        int tenths = 200;
+        for (int i = 0; i < 100000; i++) {
+            if (percent(walk) >= repeat_percentage)
+                tenths += direction(walk) ? 1 : -1;
+            reference_data.push_back(static_cast<float>(tenths) / 10.0f);
+        }
+
+        XorCompressedColumn<float> column(getAttributeString<float>());
+        column.insert(reference_data.begin(), reference_data.end());
+        REQUIRE_THAT(column, isEqual<XorCompressedColumn<float>>(reference_data));
+        double ratio = static_cast<double>(reference_data.size() * sizeof(float)) /
+                       static_cast<double>(column.getSizeInBytes());
+        std::cout << repeat_percentage << "% repetitions: compression ratio " << ratio << std::endl;
+        REQUIRE(ratio > 5.0);
+    }
+
+    // values that do not round trip with the exponent of their block are exceptions, blocks without decimals fall
+    // back to XOR
+    std::vector<float> reference_data;
+    for (int i = 0; i < 20 * static_cast<int>(XorCompressedColumn<float>::BLOCK_SIZE) + 17; i++)
+        reference_data.push_back(static_cast<float>(i % 1000 - 500) / 100.0f);
+    const std::vector<float> specials{std::numeric_limits<float>::quiet_NaN(), -0.0f,
+                                      std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+                                      1.0f / 3.0f, 3e9f, -1e-20f, std::numeric_limits<float>::max(),
+                                      std::numeric_limits<float>::denorm_min()};
+    for (size_t i = 0; i < reference_data.size(); i += 97)
+        reference_data[i] = specials[i % specials.size()];
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> noise(0.0f, 1.0f);
+    for (size_t i = 5 * XorCompressedColumn<float>::BLOCK_SIZE; i < 6 * XorCompressedColumn<float>::BLOCK_SIZE; i++)
+        reference_data[i] = noise(gen);
+
+    // compares bit patterns, so NaN and -0.0 are checked as well
+    auto requireBitwiseEqual = [&reference_data](XorCompressedColumn<float> &column) {
+        REQUIRE(column.size() == reference_data.size());
+        std::vector<float> values(column.size());
+        column.decompress(0, static_cast<TID>(values.size()), values.data());
+        REQUIRE(std::memcmp(values.data(), reference_data.data(), values.size() * sizeof(float)) == 0);
+        for (size_t i = 0; i < reference_data.size(); i += 13) {
+            float value = column[static_cast<int>(i)];
+            REQUIRE(std::memcmp(&value, &reference_data[i], sizeof(float)) == 0);
+        }
+    };
+
+    XorCompressedColumn<float> column(getAttributeString<float>());
+    column.insert(reference_data.begin(), reference_data.end());
+    requireBitwiseEqual(column);
+    REQUIRE(column.getSizeInBytes() * 2 < reference_data.size() * sizeof(float));
+
+    for (float value: {-0.5f, 0.0f, 2.5f}) {
+        for (ValueComparator comp: {EQUAL, LESSER, GREATER}) {
+            PositionList expected;
+            for (TID tid = 0; tid < reference_data.size(); tid++)
+                if ((comp == EQUAL && reference_data[tid] == value) || (comp == LESSER && reference_data[tid] < value) ||
+                    (comp == GREATER && reference_data[tid] > value))
+                    expected.push_back(tid);
+            REQUIRE(column.selection(value, comp) == expected);
+        }
+    }
+
+    for (TID tid: {TID(3), TID(700), TID(5 * XorCompressedColumn<float>::BLOCK_SIZE + 1)}) {
+        reference_data[tid] = -0.0f;
+        column.update(tid, ColumnType(-0.0f));
+        reference_data[tid + 1] = 12.34f;
+        column.update(tid + 1, ColumnType(12.34f));
+    }
+    requireBitwiseEqual(column);
+
+    PositionList removed{0, 255, 256, 2000};
+    for (auto tid = removed.rbegin(); tid != removed.rend(); ++tid)
+        reference_data.erase(reference_data.begin() + *tid);
+    column.remove(removed);
+    requireBitwiseEqual(column);
+
+    std::cout << " ----- XOR compression ratio tests done ----- " << std::endl;
+}
+
+TEST_CASE("Dictionary compressed column size", "[class][size]") {
+    // long strings live on the heap twice, in the dictionary and as keys of the hash index
+    std::vector<std::string> reference_data;
+    size_t heap_bytes = 0;
+    for (int i = 0; i < 1000; i++) {
+        reference_data.push_back("https://www.example.com/some/rather/long/path/" + std::to_string(i % 100));
+        if (i < 100)
+            heap_bytes += detail::heapBytes(reference_data.back());
+    }
+    DictionaryCompressedColumn<std::string> column(getAttributeString<std::string>());
+    column.insert(reference_data.begin(), reference_data.end());
+    REQUIRE(column.getSizeInBytes() >= 2 * heap_bytes + 100 * (sizeof(std::string) + detail::index_entry_bytes<std::string>));
+
+    DictionaryCompressedColumn<int> int_column(getAttributeString<int>());
+    for (int i = 0; i < 1000; i++)
+        int_column.insert(i);
+    REQUIRE(int_column.getSizeInBytes() >= 1000 * (sizeof(int) + detail::index_entry_bytes<int>));
+}
+
+TEST_CASE("Front coded dictionary column", "[class][string]") {
+    FrontCodedDictionaryColumn col_one(getAttributeString<std::string>());
+    FrontCodedDictionaryColumn col_two(getAttributeString<std::string>());
+    std::vector<std::string> reference_data(1000);
+
+    std::cout << " ----- Running front coded insert tests ----- " << std::endl;
+
+    /****** INSERT TEST ******/
+    // few distinct values sharing long prefixes, inserted one by one into the pending dictionary
+    std::uniform_int_distribution dist(0, 99);
+    for (auto &value: reference_data) {
+        int key = dist(gen);
+        value = "customer/" + std::to_string(key % 7) + "/order_" + std::to_string(key);
+        REQUIRE_NOTHROW(col_one.insert(value));
+    }
+    reference_data[3] = "";
+    REQUIRE_NOTHROW(col_one.update(3, reference_data[3]));
+    REQUIRE_THAT(col_one, isEqual<FrontCodedDictionaryColumn>(reference_data));
+
+    FrontCodedDictionaryColumn col_range(getAttributeString<std::string>());
+    REQUIRE_NOTHROW(col_range.insert(reference_data.begin(), reference_data.end()));
+    REQUIRE_THAT(col_range, isEqual<FrontCodedDictionaryColumn>(reference_data));
+    REQUIRE(col_range.getSizeInBytes() < reference_data.size() * sizeof(std::string));
+
+    // a single pass iterator invalidates the previous value when it advances
+    std::istringstream stream("a b b c d d d a");
+    FrontCodedDictionaryColumn col_stream(getAttributeString<std::string>());
+    REQUIRE_NOTHROW(col_stream.insert(std::istream_iterator<std::string>(stream), std::istream_iterator<std::string>()));
+    std::vector<std::string> stream_data = {"a", "b", "b", "c", "d", "d", "d", "a"};
+    REQUIRE_THAT(col_stream, isEqual<FrontCodedDictionaryColumn>(stream_data));
+
+    std::cout << " ----- Front coded insert tests done ----- " << std::endl;
+
+    std::cout << " ----- Running front coded update and delete tests ----- " << std::endl;
+
+    /****** UPDATE AND DELETE TEST ******/
+    for (TID tid = 0; tid < reference_data.size(); tid += 10) {
+        reference_data[tid] = get_rand_value<std::string>();
+        REQUIRE_NOTHROW(col_one.update(tid, reference_data[tid]));
+    }
+    PositionList tids;
+    for (TID tid = 0; tid < reference_data.size(); tid += 3)
+        tids.push_back(tid);
+    for (auto rit = tids.rbegin(); rit != tids.rend(); ++rit)
+        reference_data.erase(reference_data.begin() + *rit);
+    REQUIRE_NOTHROW(col_one.remove(tids));
+    REQUIRE_THAT(col_one, isEqual<FrontCodedDictionaryColumn>(reference_data));
+
+    std::cout << " ----- Front coded update and delete tests done ----- " << std::endl;
+
+    std::cout << " ----- Running front coded selection and sort tests ----- " << std::endl;
+
+    /****** SELECTION AND SORT TEST ******/
+    for (const std::string &comparison_value: {reference_data[reference_data.size() / 2], std::string("customer/3"),
+                                               std::string("missing")}) {
+        for (ValueComparator comp: {EQUAL, LESSER, GREATER}) {
+            PositionList expected;
+            for (TID i = 0; i < reference_data.size(); i++) {
+                if ((comp == EQUAL && reference_data[i] == comparison_value) ||
+                    (comp == LESSER && reference_data[i] < comparison_value) ||
+                    (comp == GREATER && reference_data[i] > comparison_value))
+                    expected.push_back(i);
+            }
+            REQUIRE(col_one.selection(comparison_value, comp) == expected);
+            REQUIRE(col_one.parallel_selection(comparison_value, comp, 4) == expected);
+        }
+    }
+
+    std::vector<std::pair<std::string, TID>> value_tid_pairs;
+    for (TID i = 0; i < reference_data.size(); i++)
+        value_tid_pairs.emplace_back(reference_data[i], i);
+    std::sort(value_tid_pairs.begin(), value_tid_pairs.end());
+    PositionList expected_order;
+    for (const auto &pair: value_tid_pairs)
+        expected_order.push_back(pair.second);
+    REQUIRE(col_one.sort(ASCENDING) == expected_order);
+    std::reverse(expected_order.begin(), expected_order.end());
+    REQUIRE(col_one.sort(DESCENDING) == expected_order);
+    REQUIRE_THAT(col_one, isEqual<FrontCodedDictionaryColumn>(reference_data));
+
+    std::cout << " ----- Front coded selection and sort tests done ----- " << std::endl;
+
+    std::cout << " ----- Running front coded store and load tests ----- " << std::endl;
+
+    /****** STORE AND LOAD TEST ******/
+    REQUIRE_NOTHROW(col_one.store(DATA_PATH));
+    col_one.clearContent();
+    REQUIRE(col_one.size() == 0);
+    REQUIRE_NOTHROW(col_two.load(DATA_PATH));
+    REQUIRE_THAT(col_two, isEqual<FrontCodedDictionaryColumn>(reference_data));
+
+    std::cout << " ----- Front coded store and load tests done ----- " << std::endl;
+}
+
+TEST_CASE("Column factory", "[factory]") {
+    std::cout << " ----- Running column factory tests ----- " << std::endl;
+
+    /****** MATERIALIZED COLUMNS ******/
+    for (AttributeType type: {AttributeType::INT, AttributeType::FLOAT, AttributeType::VARCHAR}) {
+        std::unique_ptr<ColumnBase> column = createColumn(type, "materialized");
+        REQUIRE(column);
+        REQUIRE(column->getType() == type);
+        REQUIRE(column->isMaterialized());
+    }
+    REQUIRE_THROWS_AS(createColumn(AttributeType::BOOLEAN, "materialized"), std::invalid_argument);
+
+    /****** ENCODING SELECTION ******/
+    std::vector<int> runs(10000), sorted(10000), random(10000);
+    std::uniform_int_distribution<int> dist;
+    for (TID i = 0; i < runs.size(); i++) {
+        runs[i] = static_cast<int>(i / 1000);
+        sorted[i] = static_cast<int>(3 * i);
+        random[i] = dist(gen);
+    }
+    REQUIRE(chooseEncoding<int>(computeStatistics(runs)) == ColumnEncoding::RUN_LENGTH);
+    REQUIRE(chooseEncoding<int>(computeStatistics(sorted)) == ColumnEncoding::FRAME_OF_REFERENCE);
+    REQUIRE(chooseEncoding<int>(computeStatistics(random)) == ColumnEncoding::UNCOMPRESSED);
+
+    std::vector<std::string> urls(10000);
+    for (auto &url: urls)
+        url = "https://example.com/products/" + std::to_string(dist(gen) % 500);
+    ColumnStatistics statistics = computeStatistics(urls);
+    REQUIRE(statistics.number_of_rows == urls.size());
+    REQUIRE_FALSE(statistics.sorted);
+    REQUIRE(chooseEncoding<std::string>(statistics) == ColumnEncoding::FRONT_CODED_DICTIONARY);
+    REQUIRE(estimateSizeInBytes<std::string>(ColumnEncoding::FRONT_CODED_DICTIONARY, statistics) <
+            estimateSizeInBytes<std::string>(ColumnEncoding::UNCOMPRESSED, statistics));
+    REQUIRE_THROWS_AS(createColumn(ColumnEncoding::XOR, "urls", urls), std::invalid_argument);
+
+    /****** SIZE ESTIMATES ******/
+    // every estimate has to be within 10% of the size the built column reports, otherwise the choice is not reliable
+    auto check_estimates = [](const auto &values) {
+        using T = typename std::decay_t<decltype(values)>::value_type;
+        ColumnStatistics batch_statistics = computeStatistics(values);
+        for (int e = 0; e <= static_cast<int>(ColumnEncoding::FRONT_CODED_DICTIONARY); e++) {
+            auto encoding = static_cast<ColumnEncoding>(e);
+            if (!isSupported<T>(encoding))
+                continue;
+            std::unique_ptr<ColumnBaseTyped<T>> column = createColumn(encoding, "estimate", values);
+            auto actual = static_cast<double>(column->getSizeInBytes());
+            auto estimate = static_cast<double>(estimateSizeInBytes<T>(encoding, batch_statistics));
+            INFO("encoding " << e << ": estimate " << estimate << ", actual " << actual);
+            REQUIRE(estimate >= 0.9 * actual);
+            REQUIRE(estimate <= 1.1 * actual);
+        }
+    };
+    check_estimates(runs);
+    check_estimates(sorted);
+    check_estimates(random);
+    check_estimates(urls);
+
+    /****** CREATION WITH THE FIRST BATCH ******/
+    std::unique_ptr<ColumnBaseTyped<int>> runs_column = createColumn("runs", runs);
+    REQUIRE(dynamic_cast<RunLengthCompressedColumn<int> *>(runs_column.get()) != nullptr);
+    std::unique_ptr<ColumnBaseTyped<std::string>> urls_column = createColumn("urls", urls);
+    REQUIRE(dynamic_cast<FrontCodedDictionaryColumn *>(urls_column.get()) != nullptr);
+    std::vector<int> decompressed_runs(runs.size());
+    runs_column->decompress(0, static_cast<TID>(runs.size()), decompressed_runs.data());
+    REQUIRE(decompressed_runs == runs);
+    std::vector<std::string> decompressed_urls(urls.size());
+    urls_column->decompress(0, static_cast<TID>(urls.size()), decompressed_urls.data());
+    REQUIRE(decompressed_urls == urls);
+
+    std::cout << " ----- Column factory tests done ----- " << std::endl;
+}
+
+TEMPLATE_TEST_CASE("Selection kernels", "[selection][simd]", int, float) {
+    std::cout << " ----- Running selection kernel tests ----- " << std::endl;
+
+    // few distinct values, so every comparator qualifies and rejects rows in every vector
+    std::vector<TestType> values(1000);
+    std::uniform_int_distribution dist(-5, 5);
+    for (auto &value: values)
+        value = static_cast<TestType>(dist(gen));
+    const TestType comparison_value = 1;
+
+    auto expected_tids = [&values, comparison_value](TID begin, TID end, ValueComparator comp) {
+        PositionList expected;
+        for (TID i = begin; i < end; i++) {
+            if ((comp == EQUAL && values[i] == comparison_value) ||
+                (comp == LESSER && values[i] < comparison_value) ||
+                (comp == GREATER && values[i] > comparison_value))
+                expected.push_back(i);
+        }
+        return expected;
+    };
+
+    /****** KERNELS ******/
+    // unaligned begin offsets and lengths that are no multiple of the vector width leave a scalar remainder
+    for (auto [begin, end]: {std::pair<TID, TID>{0, 0}, {0, 3}, {0, 8}, {0, 1000}, {1, 4}, {3, 20}, {5, 38},
+                             {7, 999}, {13, 13}}) {
+        for (ValueComparator comp: {EQUAL, LESSER, GREATER}) {
+            PositionList expected = expected_tids(begin, end, comp);
+            PositionList tids(end - begin);
+            tids.resize(selectValues(values.data(), begin, end, comparison_value, comp, tids.data()));
+            REQUIRE(tids == expected);
+
+            // every kernel the dispatch may pick, not only the one of the executing CPU
+            std::vector<std::function<size_t(TID *)>> kernels;
+            kernels.emplace_back([&](TID *out) {
+                switch (comp) {
+                    case EQUAL:
+                        return detail::selectScalar<EQUAL>(values.data(), begin, end, comparison_value, out);
+                    case LESSER:
+                        return detail::selectScalar<LESSER>(values.data(), begin, end, comparison_value, out);
+                    default:
+                        return detail::selectScalar<GREATER>(values.data(), begin, end, comparison_value, out);
+                }
+            });
+#ifdef COGADB_X86_SIMD
+            kernels.emplace_back([&](TID *out) {
+                switch (comp) {
+                    case EQUAL:
+                        return detail::selectSSE2<EQUAL>(values.data(), begin, end, comparison_value, out);
+                    case LESSER:
+                        return detail::selectSSE2<LESSER>(values.data(), begin, end, comparison_value, out);
+                    default:
+                        return detail::selectSSE2<GREATER>(values.data(), begin, end, comparison_value, out);
+                }
+            });
+            if (cpuSupportsAVX2()) {
+                kernels.emplace_back([&](TID *out) {
+                    switch (comp) {
+                        case EQUAL:
+                            return detail::selectAVX2<EQUAL>(values.data(), begin, end, comparison_value, out);
+                        case LESSER:
+                            return detail::selectAVX2<LESSER>(values.data(), begin, end, comparison_value, out);
+                        default:
+                            return detail::selectAVX2<GREATER>(values.data(), begin, end, comparison_value, out);
+                    }
+                });
+            }
+#endif
+            for (const auto &kernel: kernels) {
+                PositionList kernel_tids(end - begin);
+                kernel_tids.resize(kernel(kernel_tids.data()));
+                REQUIRE(kernel_tids == expected);
+            }
+        }
+    }
+
+    // the bit kernels overwrite every word and clear the bits behind count
+    for (size_t count: {size_t(0), size_t(3), size_t(8), size_t(64), size_t(100), size_t(1000)}) {
+        for (ValueComparator comp: {EQUAL, LESSER, GREATER}) {
+            Bitmap expected_bitmap = Bitmap::fromPositionList(expected_tids(0, static_cast<TID>(count), comp), count);
+            const std::vector<uint64_t> &expected = expected_bitmap.words();
+            std::vector<std::function<void(uint64_t *)>> kernels;
+            kernels.emplace_back([&](uint64_t *words) {
+                selectBits(values.data(), count, comparison_value, comp, words);
+            });
+            kernels.emplace_back([&](uint64_t *words) {
+                switch (comp) {
+                    case EQUAL:
+                        return detail::selectBitsScalar<EQUAL>(values.data(), count, comparison_value, words);
+                    case LESSER:
+                        return detail::selectBitsScalar<LESSER>(values.data(), count, comparison_value, words);
+                    default:
+                        return detail::selectBitsScalar<GREATER>(values.data(), count, comparison_value, words);
+                }
+            });
+#ifdef COGADB_X86_SIMD
+            kernels.emplace_back([&](uint64_t *words) {
+                switch (comp) {
+                    case EQUAL:
+                        return detail::selectBitsSSE2<EQUAL>(values.data(), count, comparison_value, words);
+                    case LESSER:
+                        return detail::selectBitsSSE2<LESSER>(values.data(), count, comparison_value, words);
+                    default:
+                        return detail::selectBitsSSE2<GREATER>(values.data(), count, comparison_value, words);
+                }
+            });
+            if (cpuSupportsAVX2()) {
+                kernels.emplace_back([&](uint64_t *words) {
+                    switch (comp) {
+                        case EQUAL:
+                            return detail::selectBitsAVX2<EQUAL>(values.data(), count, comparison_value, words);
+                        case LESSER:
+                            return detail::selectBitsAVX2<LESSER>(values.data(), count, comparison_value, words);
+                        default:
+                            return detail::selectBitsAVX2<GREATER>(values.data(), count, comparison_value, words);
+                    }
+                });
+            }
+#endif
+            for (const auto &kernel: kernels) {
+                std::vector<uint64_t> words(expected.size(), ~uint64_t(0));
+                kernel(words.data());
+                REQUIRE(words == expected);
+            }
+        }
+    }
+
+    /****** UNCOMPRESSED COLUMN ******/
+    Column<TestType> column(getAttributeString<TestType>());
+    column.insert(values.begin(), values.begin() + 997);
+    for (ValueComparator comp: {EQUAL, LESSER, GREATER}) {
+        PositionList expected = expected_tids(0, 997, comp);
+        REQUIRE(column.selection(comparison_value, comp) == expected);
+        REQUIRE(column.parallel_selection(comparison_value, comp, 4) == expected);
+        REQUIRE(column.bitmap_selection(comparison_value, comp) == Bitmap::fromPositionList(expected, 997));
+    }
+
+    std::cout << " ----- Selection kernel tests done ----- " << std::endl;
+}
+
+TEST_CASE("Parallel selection over several morsels", "[selection][parallel]") {
+    std::cout << " ----- Running parallel selection tests ----- " << std::endl;
+
+    // five full morsels and a partial one, so the workers claim morsels concurrently and their results are merged
+    const size_t size = 5 * ColumnBaseTyped<int>::MORSEL_SIZE + 123;
+    std::vector<int> reference_data(size);
+    std::uniform_int_distribution dist(-1000, 1000);
+    for (auto &value: reference_data)
+        value = dist(gen);
+
+    DictionaryCompressedColumn<int> col_dictionary("dictionary");
+    col_dictionary.insert(reference_data.begin(), reference_data.end());
+    FrameOfReferenceColumn<int> col_for("frame of reference");
+    col_for.insert(reference_data.begin(), reference_data.end());
+
+    for (int comparison_value: {0, 42, 5000}) {
+        for (ValueComparator comp: {EQUAL, LESSER, GREATER}) {
+            PositionList expected;
+            for (TID i = 0; i < reference_data.size(); i++) {
+                if ((comp == EQUAL && reference_data[i] == comparison_value) ||
+                    (comp == LESSER && reference_data[i] < comparison_value) ||
+                    (comp == GREATER && reference_data[i] > comparison_value))
+                    expected.push_back(i);
+            }
+            for (unsigned int number_of_threads: {2u, 4u, 7u}) {
+                REQUIRE(col_dictionary.parallel_selection(comparison_value, comp, number_of_threads) == expected);
+                REQUIRE(col_for.parallel_selection(comparison_value, comp, number_of_threads) == expected);
+            }
+        }
+    }
+
+    std::cout << " ----- Parallel selection tests done ----- " << std::endl;
+}
+
+TEMPLATE_TEST_CASE("Column arithmetic over several morsels", "[arithmetic][parallel]", int, float) {
+    std::cout << " ----- Running column arithmetic tests ----- " << std::endl;
+
+    // three full morsels and a partial one, the results of the workers are appended to the result in tid order
+    const size_t size = 3 * ColumnBaseTyped<TestType>::MORSEL_SIZE + 77;
+    std::vector<TestType> left_data(size), right_data(size);
+    std::uniform_int_distribution dist(-1000, 1000), divisor(1, 50);
+    for (size_t i = 0; i < size; i++) {
+        left_data[i] = static_cast<TestType>(dist(gen));
+        right_data[i] = static_cast<TestType>(i % 2 == 0 ? divisor(gen) : -divisor(gen));
+    }
+    FrameOfReferenceColumn<TestType> left("left");
+    left.insert(left_data.begin(), left_data.end());
+    DictionaryCompressedColumn<TestType> right("right");
+    right.insert(right_data.begin(), right_data.end());
+
+    for (ColumnAlgebraOperation op: {ADD, SUB, MUL, DIV}) {
+        std::vector<TestType> expected(size);
+        for (size_t i = 0; i < size; i++)
+            expected[i] = applyOperation(op, left_data[i], right_data[i]);
+        for (unsigned int number_of_threads: {1u, 2u, 4u, 7u}) {
+            REQUIRE_THAT(computeColumn(left, right, op, "result", number_of_threads),
+                         isEqual<Column<TestType>>(expected));
+            REQUIRE_THAT(computeColumn<DeltaEncodedColumn>(left, right, op, "result", number_of_threads),
+                         isEqual<DeltaEncodedColumn<TestType>>(expected));
+        }
+
+        FrameOfReferenceColumn<TestType> target("target");
+        target.insert(left_data.begin(), left_data.end());
+        Column<TestType> operand("operand");
+        operand.insert(right_data.begin(), right_data.end());
+        switch (op) {
+            case ADD:
+                REQUIRE(target.add(operand));
+                break;
+            case SUB:
+                REQUIRE(target.minus(operand));
+                break;
+            case MUL:
+                REQUIRE(target.multiply(operand));
+                break;
+            case DIV:
+                REQUIRE(target.division(operand));
+                break;
+        }
+        REQUIRE_THAT(target, isEqual<FrameOfReferenceColumn<TestType>>(expected));
+    }
+
+    // a single divisor of 0 in the last morsel fails integer divisions without touching the column, floats divide to
+    // infinity
+    right_data[size - 3] = TestType(0);
+    right.update(size - 3, ColumnType(TestType(0)));
+    if constexpr(std::is_integral_v<TestType>) {
+        for (unsigned int number_of_threads: {1u, 4u})
+            REQUIRE_THROWS_AS(computeColumn(left, right, DIV, "result", number_of_threads), std::invalid_argument);
+        REQUIRE_FALSE(left.division(right));
+        REQUIRE_THAT(left, isEqual<FrameOfReferenceColumn<TestType>>(left_data));
+        std::vector<TestType> expected(size);
+        for (size_t i = 0; i < size; i++)
+            expected[i] = left_data[i] * right_data[i];
+        REQUIRE_THAT(computeColumn(left, right, MUL, "result"), isEqual<Column<TestType>>(expected));
+    } else {
+        Column<TestType> quotient = computeColumn(left, right, DIV, "result", 4);
+        REQUIRE(std::isinf(quotient[static_cast<int>(size - 3)]) == (left_data[size - 3] != 0));
+    }
+
+    // columns of another type or size are rejected
+    using OtherType = std::conditional_t<std::is_same_v<TestType, int>, float, int>;
+    std::vector<OtherType> ones(size, OtherType(1));
+    Column<OtherType> other_type("other type");
+    other_type.insert(ones.begin(), ones.end());
+    REQUIRE_FALSE(left.add(other_type));
+    right.remove(0);
+    REQUIRE_THROWS_AS(computeColumn(left, right, ADD, "result", 4), std::invalid_argument);
+    REQUIRE_FALSE(left.add(right));
+    REQUIRE_THAT(left, isEqual<FrameOfReferenceColumn<TestType>>(left_data));
+
+    std::cout << " ----- Column arithmetic tests done ----- " << std::endl;
+}
+
+TEST_CASE("Parallel radix hash join", "[join][parallel]") {
+    std::cout << " ----- Running parallel join tests ----- " << std::endl;
+
+    // both inputs together exceed the threshold and the build side is partitioned into several partitions
+    const size_t size = ColumnBaseTyped<int>::PARALLEL_JOIN_THRESHOLD / 2 + 1000;
+    std::vector<int> left(size), right(size);
+    std::uniform_int_distribution dist(0, 20000);
+    for (TID i = 0; i < size; i++) {
+        left[i] = dist(gen);
+        right[i] = dist(gen);
+    }
+
+    // expected result as a multiset of pairs
+    std::unordered_map<int, PositionList> right_tids;
+    for (TID i = 0; i < size; i++)
+        right_tids[right[i]].push_back(i);
+    std::vector<std::pair<TID, TID>> expected_pairs;
+    for (TID i = 0; i < size; i++) {
+        auto it = right_tids.find(left[i]);
+        if (it != right_tids.end()) {
+            for (TID j: it->second)
+                expected_pairs.emplace_back(i, j);
+        }
+    }
+    std::sort(expected_pairs.begin(), expected_pairs.end());
+    REQUIRE(!expected_pairs.empty());
+
+    auto sorted_pairs = [](const PositionListPair &join_tids) {
+        REQUIRE(join_tids.first.size() == join_tids.second.size());
+        std::vector<std::pair<TID, TID>> pairs;
+        for (size_t i = 0; i < join_tids.first.size(); i++)
+            pairs.emplace_back(join_tids.first[i], join_tids.second[i]);
+        std::sort(pairs.begin(), pairs.end());
+        return pairs;
+    };
+
+    Column<int> col_left("left");
+    col_left.insert(left.begin(), left.end());
+    DeltaEncodedColumn<int> col_right("right");
+    col_right.insert(right.begin(), right.end());
+    REQUIRE(sorted_pairs(col_left.hash_join(col_right)) == expected_pairs);
+
+    // the number of threads of hash_join depends on the machine, so the join is run with fixed ones as well
+    for (unsigned int number_of_threads: {2u, 4u, 7u}) {
+        REQUIRE(sorted_pairs(detail::radixHashJoin(left, right, number_of_threads)) == expected_pairs);
+        // equal sizes build the hash table on the left input, a smaller right input builds it on the right one
+        std::vector<int> smaller_right(right.begin(), right.begin() + size / 2);
+        std::vector<std::pair<TID, TID>> expected_smaller;
+        std::copy_if(expected_pairs.begin(), expected_pairs.end(), std::back_inserter(expected_smaller),
+                     [size](const std::pair<TID, TID> &pair) { return pair.second < size / 2; });
+        REQUIRE(sorted_pairs(detail::radixHashJoin(left, smaller_right, number_of_threads)) == expected_smaller);
+    }
+
+    std::cout << " ----- Parallel join tests done ----- " << std::endl;
+}
+
+TEMPLATE_TEST_CASE("Parallel sort", "[sort][parallel]", int, float, std::string) {
+    std::cout << " ----- Running parallel sort tests ----- " << std::endl;
+
+    // above the threshold and with many ties, which have to stay ordered by tid
+    const size_t size = ColumnBaseTyped<TestType>::PARALLEL_SORT_THRESHOLD + 777;
+    std::vector<TestType> reference_data(size);
+    std::uniform_int_distribution dist(-500, 500);
+    for (auto &value: reference_data) {
+        int key = dist(gen);
+        if constexpr(std::is_same_v<TestType, std::string>)
+            value = "key_" + std::to_string(key);
+        else if constexpr(std::is_same_v<TestType, float>)
+            value = key == 0 && dist(gen) < 0 ? -0.0f : static_cast<float>(key) / 4;
+        else
+            value = key;
+    }
+
+    std::vector<std::pair<TestType, TID>> value_tid_pairs;
+    for (TID i = 0; i < size; i++)
+        value_tid_pairs.emplace_back(reference_data[i], i);
+    std::stable_sort(value_tid_pairs.begin(), value_tid_pairs.end(),
+                     [](const auto &a, const auto &b) { return a.first < b.first; });
+    PositionList expected_ascending;
+    for (const auto &pair: value_tid_pairs)
+        expected_ascending.push_back(pair.second);
+    PositionList expected_descending(expected_ascending.rbegin(), expected_ascending.rend());
+
+    Column<TestType> column(getAttributeString<TestType>());
+    column.insert(reference_data.begin(), reference_data.end());
+    REQUIRE(column.sort(ASCENDING) == expected_ascending);
+    REQUIRE(column.sort(DESCENDING) == expected_descending);
+
+    // the number of threads of sort depends on the machine, so the sort is run with fixed ones as well
+    for (unsigned int number_of_threads: {2u, 4u, 7u}) {
+        REQUIRE(parallelSort(reference_data, ASCENDING, number_of_threads) == expected_ascending);
+        REQUIRE(parallelSort(reference_data, DESCENDING, number_of_threads) == expected_descending);
+    }
+
+    std::cout << " ----- Parallel sort tests done ----- " << std::endl;
+}
+
+TEST_CASE("Frequency partitioned column with skewed data", "[class][partitions]") {
+    std::cout << " ----- Running frequency partitioned tests ----- " << std::endl;
+
+    // hot values fill the narrowest partition, warm ones the next and the many cold ones spill into the widest two;
+    // the value ranges of the partitions barely overlap, so selections skip or accept whole partitions
+    std::vector<int> reference_data(200000);
+    std::uniform_int_distribution percent(0, 99), hot(0, 9), warm(100, 299), cold(1000, 1000000);
+    for (auto &value: reference_data) {
+        int p = percent(gen);
+        value = p < 45 ? hot(gen) : p < 60 ? warm(gen) : cold(gen);
+    }
+
+    /****** BULK INSERT TEST ******/
+    // the bulk insert repartitions the column by the frequencies of the values
+    FrequencyPartitionedColumn<int> column(getAttributeString<int>());
+    REQUIRE_NOTHROW(column.insert(reference_data.begin(), reference_data.end()));
+    REQUIRE_THAT(column, isEqual<FrequencyPartitionedColumn<int>>(reference_data));
+
+    auto check_selections = [&column, &reference_data]() {
+        for (int comparison_value: {-7, 3, 9, 10, 150, 5000, 2000000}) {
+            for (ValueComparator comp: {EQUAL, LESSER, GREATER}) {
+                PositionList expected;
+                for (TID i = 0; i < reference_data.size(); i++) {
+                    if ((comp == EQUAL && reference_data[i] == comparison_value) ||
+                        (comp == LESSER && reference_data[i] < comparison_value) ||
+                        (comp == GREATER && reference_data[i] > comparison_value))
+                        expected.push_back(i);
+                }
+                REQUIRE(column.selection(comparison_value, comp) == expected);
+                REQUIRE(column.parallel_selection(comparison_value, comp, 4) == expected);
+            }
+        }
+    };
+    check_selections();
+
+    /****** UPDATE TEST ******/
+    // rows move into the hot partition, into the widest one with a new value and between the cold partitions
+    std::uniform_int_distribution<TID> tids(0, static_cast<TID>(reference_data.size() - 1));
+    for (int new_value: {3, -7, reference_data[17]}) {
+        for (int i = 0; i < 300; i++) {
+            TID tid = tids(gen);
+            reference_data[tid] = new_value;
+            REQUIRE_NOTHROW(column.update(tid, new_value));
+        }
+    }
+    REQUIRE_THAT(column, isEqual<FrequencyPartitionedColumn<int>>(reference_data));
+
+    /****** DELETE TEST ******/
+    for (int i = 0; i < 200; i++) {
+        TID tid = tids(gen) % static_cast<TID>(reference_data.size());
+        reference_data.erase(reference_data.begin() + tid);
+        REQUIRE_NOTHROW(column.remove(tid));
+    }
+    PositionList removed;
+    for (TID tid = 0; tid < reference_data.size(); tid += 97)
+        removed.push_back(tid);
+    for (auto rit = removed.rbegin(); rit != removed.rend(); ++rit)
+        reference_data.erase(reference_data.begin() + *rit);
+    REQUIRE_NOTHROW(column.remove(removed));
+    REQUIRE_THAT(column, isEqual<FrequencyPartitionedColumn<int>>(reference_data));
+    check_selections();
+
+    /****** REPARTITION TEST ******/
+    REQUIRE_NOTHROW(column.repartition());
+    REQUIRE_THAT(column, isEqual<FrequencyPartitionedColumn<int>>(reference_data));
+    check_selections();
+
+    std::cout << " ----- Frequency partitioned tests done ----- " << std::endl;
+}
+
+TEST_CASE("Frame of reference column with outliers", "[class][exceptions]") {
+    std::cout << " ----- Running frame of reference tests ----- " << std::endl;
+
+    const int min = std::numeric_limits<int>::min(), max = std::numeric_limits<int>::max();
+    const size_t block_size = FOR_BLOCK_SIZE;
+    std::uniform_int_distribution narrow(-8, 7), full(min, max);
+
+    // every block exercises another bit width: constant blocks need no bits, narrow negative blocks with extreme
+    // outliers store the outliers as exceptions and uniformly distributed blocks need all 32 bits
+    std::vector<int> reference_data;
+    for (int repetition = 0; repetition < 4; repetition++) {
+        reference_data.insert(reference_data.end(), block_size, 42);
+        reference_data.insert(reference_data.end(), block_size, -5);
+        for (size_t i = 0; i < block_size; i++)
+            reference_data.push_back(i == 5 ? min : i == 100 ? max : narrow(gen));
+        for (size_t i = 0; i < block_size; i++)
+            reference_data.push_back(full(gen));
+    }
+    // the last values do not fill a block
+    for (int i = 0; i < 50; i++)
+        reference_data.push_back(i % 2 ? min : narrow(gen));
+
+    FrameOfReferenceColumn<int> column(getAttributeString<int>());
+    REQUIRE_NOTHROW(column.insert(reference_data.begin(), reference_data.end()));
+    REQUIRE_THAT(column, isEqual<FrameOfReferenceColumn<int>>(reference_data));
+
+    auto check_selections = [&column, &reference_data, min, max]() {
+        for (int comparison_value: {min, max, -5, 0, 42, reference_data[3 * FOR_BLOCK_SIZE + 7]}) {
+            for (ValueComparator comp: {EQUAL, LESSER, GREATER}) {
+                PositionList expected;
+                for (TID i = 0; i < reference_data.size(); i++) {
+                    if ((comp == EQUAL && reference_data[i] == comparison_value) ||
+                        (comp == LESSER && reference_data[i] < comparison_value) ||
+                        (comp == GREATER && reference_data[i] > comparison_value))
+                        expected.push_back(i);
+                }
+                REQUIRE(column.selection(comparison_value, comp) == expected);
+            }
+        }
+    };
+    check_selections();
+
+    /****** EXCEPTION SIZE TEST ******/
+    // two outliers per block must not widen the offsets of the other values to 32 bits
+    std::vector<int> outlier_data;
+    for (size_t i = 0; i < 100 * block_size; i++)
+        outlier_data.push_back(i % block_size == 5 ? min : i % block_size == 100 ? max : narrow(gen));
+    FrameOfReferenceColumn<int> col_outliers(getAttributeString<int>());
+    col_outliers.insert(outlier_data.begin(), outlier_data.end());
+    REQUIRE_THAT(col_outliers, isEqual<FrameOfReferenceColumn<int>>(outlier_data));
+    REQUIRE(col_outliers.getSizeInBytes() < outlier_data.size() * sizeof(int) / 4);
+
+    /****** UPDATE TEST ******/
+    // outliers in constant and narrow blocks add exceptions, replacing the outliers removes them again
+    const std::vector<std::pair<TID, int>> updates = {
+            {3, max}, {4, min}, {block_size + 1, max}, {2 * block_size + 5, 0}, {2 * block_size + 100, -1},
+            {2 * block_size + 6, min}, {2 * block_size + 7, max}, {2 * block_size + 8, 12345678},
+            {3 * block_size + 9, 0}, {3, 42}, {4, 42}, {static_cast<TID>(reference_data.size() - 1), max}};
+    for (auto [tid, new_value]: updates) {
+        reference_data[tid] = new_value;
+        REQUIRE_NOTHROW(column.update(tid, new_value));
+        REQUIRE_THAT(column, isEqual<FrameOfReferenceColumn<int>>(reference_data));
+    }
+    for (size_t i = 0; i < block_size; i += 2) {
+        TID tid = static_cast<TID>(4 * block_size + i);
+        reference_data[tid] = i % 4 ? min : max;
+        REQUIRE_NOTHROW(column.update(tid, reference_data[tid]));
+    }
+    REQUIRE_THAT(column, isEqual<FrameOfReferenceColumn<int>>(reference_data));
+    check_selections();
+
+    /****** DELETE TEST ******/
+    // removing rows shifts the following values across block boundaries
+    for (TID tid: {static_cast<TID>(2 * block_size + 5), static_cast<TID>(7), static_cast<TID>(block_size - 1)}) {
+        reference_data.erase(reference_data.begin() + tid);
+        REQUIRE_NOTHROW(column.remove(tid));
+    }
+    REQUIRE_THAT(column, isEqual<FrameOfReferenceColumn<int>>(reference_data));
+    check_selections();
+
+    std::cout << " ----- Frame of reference tests done ----- " << std::endl;
+}